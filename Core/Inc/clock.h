@@ -0,0 +1,51 @@
+#ifndef CLOCK_H
+#define CLOCK_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "main.h"
+
+/* System clock profiles. SystemClock_Config() (CubeMX) boots on the 8 MHz
+   HSI; clock_set_profile() moves between the profiles at run time and
+   re-derives the I2C1 and USART2 timings from the new PCLK1.
+
+   Profile              SYSCLK  HCLK  PCLK1  PCLK2  Flash latency
+   HSI_8MHZ  (HSI)       8 MHz   8     8      8     0 WS
+   HSI_64MHZ (HSI/2*16) 64 MHz  64    32     64     2 WS
+   HSE_72MHZ (HSE*9)    72 MHz  72    36     72     2 WS  (8 MHz crystal)
+
+   PCLK1 is limited to 36 MHz, hence APB1 /2 on the PLL profiles. */
+typedef enum {
+    CLOCK_PROFILE_HSI_8MHZ = 0,   /* low power, no PLL */
+    CLOCK_PROFILE_HSI_64MHZ,      /* fastest without a crystal */
+    CLOCK_PROFILE_HSE_72MHZ,      /* maximum rated speed */
+    CLOCK_PROFILE_COUNT
+} clock_profile_t;
+
+/* Longest wait for the E32 TX queue to drain before USART2 is re-timed */
+#ifndef CLOCK_UART_DRAIN_MS
+#define CLOCK_UART_DRAIN_MS 1000
+#endif
+
+/* Switch to profile p. Waits for a running display transfer and for the E32
+   TX queue to finish (HAL_BUSY if they do not within SSD1306_I2C_TIMEOUT_MS
+   and CLOCK_UART_DRAIN_MS; the clock is left unchanged), drops to HSI while
+   the PLL is reprogrammed, then re-times I2C1 and USART2 if they are
+   initialized. If the HSE or the PLL does not start, the core is left on HSI
+   8 MHz and the error is returned. Call from thread context only.
+
+   A throughput-critical burst can run on a faster profile:
+       clock_profile_t prev = clock_get_profile();
+       clock_set_profile(CLOCK_PROFILE_HSE_72MHZ);
+       ... full redraw ...
+       clock_set_profile(prev); */
+HAL_StatusTypeDef clock_set_profile(clock_profile_t p);
+clock_profile_t clock_get_profile(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CLOCK_H */
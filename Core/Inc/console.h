@@ -0,0 +1,50 @@
+#ifndef CONSOLE_H
+#define CONSOLE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stddef.h>
+#include "ssd1306.h"
+
+/* Scrolling text console on the SSD1306 in the 5x8 font: 21 columns x 8 rows,
+   one page per row.
+
+   The text is kept in a character-cell buffer. When the cursor moves past the
+   bottom row the display start line is advanced by one page instead of
+   redrawing the screen: the row that scrolled out is blanked and reused as
+   the new bottom row, so a new line costs one row of I2C traffic.
+
+   '\n' ends the line. The move to the next row is deferred until the next
+   character arrives, so the last line written stays on the bottom row and
+   the row scrolled in is drawn together with its text. '\r' returns to the
+   start of the line, '\b' moves back one cell, other control characters are
+   ignored. Long lines wrap.
+
+   The console owns the whole screen unless it is hidden. Drawing follows the
+   display mode: in framebuffer mode the caller still flushes. */
+
+#define CONSOLE_CELL_WIDTH 6 /* 5x8 glyph + 1 spacing column */
+#define CONSOLE_COLS (SSD1306_WIDTH / CONSOLE_CELL_WIDTH)
+#define CONSOLE_ROWS SSD1306_PAGES
+
+/* Clear the screen and the cell buffer, reset the cursor and the scroll.
+   While the console is hidden the screen is left alone. */
+void console_clear(void);
+
+/* Hand the screen to another view (0) or take it back (1). While hidden, text
+   only goes to the cell buffer; showing the console again clears the screen
+   and redraws every row. */
+void console_set_visible(uint8_t visible);
+
+void console_putc(char c);
+void console_write(const char *s, size_t n);
+void console_puts(const char *s);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CONSOLE_H */
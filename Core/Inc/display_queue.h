@@ -0,0 +1,74 @@
+#ifndef DISPLAY_QUEUE_H
+#define DISPLAY_QUEUE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include "ssd1306.h"
+
+/* Render request queue between packet handling and drawing, both in the
+   main loop.
+
+   E32_Poll() posts the text lines and TEXT frames it receives;
+   display_queue_drain() draws them later in the same loop pass, right
+   before ssd1306_flush_async(). All packets of one pass are thus drawn
+   together and go out in one flush, and a burst of packets that outruns the
+   display is dropped here (display_queue_dropped()) instead of stalling the
+   receive path.
+
+   There is exactly one producer and one consumer, and both are main-loop
+   code. The ring keeps its head/tail barriers, but posting from an
+   interrupt is not supported: no such producer exists or is tested. */
+
+/* Number of slots, must be a power of two */
+#ifndef DISPLAY_QUEUE_SIZE
+#define DISPLAY_QUEUE_SIZE 8
+#endif
+
+/* Longest text a request can carry, including the terminating 0 */
+#ifndef DISPLAY_QUEUE_TEXT_MAX
+#define DISPLAY_QUEUE_TEXT_MAX 32
+#endif
+
+typedef enum {
+    DISPLAY_REQ_CLEAR = 0,   /* clear the whole screen */
+    DISPLAY_REQ_TEXT,        /* draw text with font at pixel (x, y) */
+    DISPLAY_REQ_CONSOLE,     /* append text as a new line of the console */
+    DISPLAY_REQ_LOG,         /* add text to the message log (msglog.h) */
+    DISPLAY_REQ_SCREEN       /* clear the screen, then draw text as TEXT */
+} display_req_type_t;
+
+typedef struct {
+    display_req_type_t type;
+    uint8_t x;
+    uint8_t y;
+    const ssd1306_font_t *font;
+    char text[DISPLAY_QUEUE_TEXT_MAX];
+} display_req_t;
+
+/* Producer side (main loop). Return 1 if queued, 0 if the queue was full
+   and the request was dropped. Text longer than the slot is cut.
+   A clear followed by a text is two requests and the second one can be
+   dropped, leaving a blank screen: post a new screen with
+   display_queue_post_screen(), which is queued or dropped as a whole. */
+uint8_t display_queue_post(const display_req_t *req);
+uint8_t display_queue_post_clear(void);
+uint8_t display_queue_post_text(const ssd1306_font_t *font, uint8_t x, uint8_t y, const char *text);
+uint8_t display_queue_post_console(const char *text);
+uint8_t display_queue_post_log(const char *text);
+uint8_t display_queue_post_screen(const ssd1306_font_t *font, uint8_t x, uint8_t y, const char *text);
+
+/* Consumer side (main loop): execute every pending request. Drawing goes to
+   the framebuffer; the caller still flushes it. */
+void display_queue_drain(void);
+
+/* Requests dropped because the queue was full */
+uint32_t display_queue_dropped(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* DISPLAY_QUEUE_H */
@@ -20,11 +20,83 @@ typedef enum {
     E32_MODE_PROGRAM
 } E32_Mode;
 
+// --- Параметри модуля (блок із 6 байтів: HEAD ADDH ADDL SPED CHAN OPTION) ---
+typedef enum {
+    E32_PARITY_8N1 = 0,
+    E32_PARITY_8O1,
+    E32_PARITY_8E1
+} E32_Parity;
+
+// Швидкість в ефірі, біти 2..0 SPED. Однакова на обох кінцях лінку.
+typedef enum {
+    E32_AIR_300 = 0,
+    E32_AIR_1200,
+    E32_AIR_2400,    // заводська
+    E32_AIR_4800,
+    E32_AIR_9600,
+    E32_AIR_19200
+} E32_AirRate;
+
+typedef struct {
+    uint8_t addh;
+    uint8_t addl;
+    E32_Parity parity;
+    uint32_t uart_baud;    // 1200..115200
+    E32_AirRate air_rate;
+    uint8_t channel;       // 0..31, частота = 410 МГц + channel (E32-433)
+    uint8_t fixed_tx;      // 1 — фіксована адресація (перші 3 байти пакета: ADDH ADDL CHAN)
+    uint8_t io_push_pull;  // 1 — TXD/AUX двотактні, 0 — відкритий стік
+    uint8_t wakeup;        // 0..7: час пробудження 250 мс * (wakeup + 1)
+    uint8_t fec;           // 1 — корекція помилок увімкнена
+    uint8_t power;         // 0..3, 0 — максимальна потужність
+} E32_Config;
+
+#define E32_CONFIG_SIZE        6
+#define E32_CONFIG_TIMEOUT_MS  1000  // відповідь модуля в режимі програмування
+#ifndef E32_MODE_SETTLE_MS
+#define E32_MODE_SETTLE_MS     100   // найдовше чекання спаду AUX після зміни M0/M1
+#endif
+
+// Бажані параметри зв'язку, які main.c записує в модуль при старті
+#ifndef E32_UART_BAUD
+#define E32_UART_BAUD  115200
+#endif
+#ifndef E32_AIR_RATE
+#define E32_AIR_RATE   E32_AIR_2400
+#endif
+
 // --- Зовнішній UART, який використовується для E32 ---
 extern UART_HandleTypeDef huart2;
 #define LORA_UART   (&huart2)
-// --- Буфер для приймання даних ---
-extern uint8_t LoRa_RX_Buffer[64];
+// --- Прийом даних ---
+// USART2 приймає через ReceiveToIdle у LoRa_RX_Buffer, звідти байти йдуть у
+// кільцевий буфер. Пакет закінчується паузою на лінії (IDLE), як E32 їх і видає.
+// E32_RX_USE_DMA = 1: кільцевий DMA (одне переривання на половину буфера або
+// паузу), 0: переривання на кожен байт. USART2_RX на F103 жорстко прив'язаний
+// до DMA1 Channel 6, який уже зайнятий I2C1_TX дисплея, тому DMA-режим
+// вимагає SSD1306_USE_DMA = 0.
+#ifndef E32_RX_USE_DMA
+#define E32_RX_USE_DMA 0
+#endif
+
+#if E32_RX_USE_DMA && SSD1306_USE_DMA
+#error "USART2_RX and I2C1_TX share DMA1 Channel 6: set SSD1306_USE_DMA to 0 to use E32_RX_USE_DMA"
+#endif
+
+#define E32_RX_DMA_SIZE     64   // розмір LoRa_RX_Buffer
+#define E32_RX_RING_SIZE    256  // кільцевий буфер байтів, степінь двійки
+#define E32_RX_MAX_PACKETS  16   // черга довжин пакетів, степінь двійки
+
+// --- Передача ---
+// E32_SendString/E32_SendByte/E32_Write лише кладуть байти в кільцевий буфер
+// і одразу повертаються. Буфер іде в USART2 через DMA (DMA1 Channel 7)
+// частинами до E32_TX_CHUNK байтів і тільки коли AUX = 1 (модуль готовий
+// прийняти дані). Наростаючий фронт AUX (EXTI14) запускає наступну частину,
+// тож опитування AUX і затримок немає.
+#define E32_TX_RING_SIZE    256  // степінь двійки
+#define E32_TX_CHUNK        58   // підпакет E32: модуль відправляє в ефір по 58 байтів
+
+extern uint8_t LoRa_RX_Buffer[E32_RX_DMA_SIZE];
 #define RX_LINE_MAX 32
 extern char rx_line[RX_LINE_MAX];
 extern uint8_t rx_idx;
@@ -35,5 +107,33 @@ void E32_SetMode(E32_Mode mode);
 uint8_t E32_IsReady(void);
 void E32_SendString(char *str);
 void E32_SendByte(uint8_t data);
+uint16_t E32_Write(const uint8_t *data, uint16_t len);
+uint16_t E32_TxPending(void);
+uint32_t E32_TxDropped(void);
+uint32_t E32_TxErrors(void);  // помилок DMA; непередана решта частини йде повторно
+
+// Конфігурація. Модуль переводиться в режим програмування (UART 9600 8N1),
+// після чого повертається попередній режим, а USART2 перелаштовується на
+// швидкість і парність UART, записані в модулі. Викликати з головного циклу.
+HAL_StatusTypeDef E32_ReadConfig(E32_Config *cfg);
+// save = 1 — зберегти у флеші модуля (C0), 0 — до вимкнення живлення (C2).
+// Записане перевіряється зворотним читанням.
+HAL_StatusTypeDef E32_WriteConfig(const E32_Config *cfg, uint8_t save);
+void E32_ConfigDecode(const uint8_t raw[E32_CONFIG_SIZE], E32_Config *cfg);
+HAL_StatusTypeDef E32_ConfigEncode(const E32_Config *cfg, uint8_t save, uint8_t raw[E32_CONFIG_SIZE]);
+
+// --- Двійкові кадри (frame.h: SYNC, LEN, TYPE, дані, CRC-16) ---
+// Прийняті кадри FRAME_TYPE_TEXT ідуть у журнал повідомлень (msglog.h), решта — обробнику.
+typedef void (*E32_FrameHandler)(uint8_t type, const uint8_t *payload, uint8_t len);
+void E32_SetFrameHandler(E32_FrameHandler handler);
+// HAL_BUSY — у черзі передачі немає місця на весь кадр
+HAL_StatusTypeDef E32_SendFrame(uint8_t type, const uint8_t *payload, uint8_t len);
+uint32_t E32_FrameErrors(void);
+
+HAL_StatusTypeDef E32_StartReceive(void);
+uint16_t E32_ReadPacket(uint8_t *buf, uint16_t max);
+uint32_t E32_RxOverruns(void);
+uint32_t E32_RxTruncated(void);  // пакетів, обрізаних E32_ReadPacket
+void E32_Poll(void);
 
 #endif
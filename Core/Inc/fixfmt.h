@@ -0,0 +1,41 @@
+#ifndef FIXFMT_H
+#define FIXFMT_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stddef.h>
+
+/* Integer-only number formatting for the display, without printf or floats.
+
+   Every function writes a NUL-terminated string into out (len bytes
+   including the terminator) and returns the number of characters written.
+   If the text does not fit, out is set to "" and 0 is returned.
+
+   Coordinates are int32 in units of 1e-7 degree (|value| <= 1 800 000 000),
+   the resolution of GNSS receivers (~1 cm). */
+
+/* Degree sign in the display fonts (glyph 0x7F) */
+#define FIXFMT_DEGREE '\x7F'
+
+size_t fixfmt_u32(char *out, size_t len, uint32_t v);
+size_t fixfmt_i32(char *out, size_t len, int32_t v);
+
+/* value / 10^decimals with exactly `decimals` fraction digits (0..9),
+   e.g. (1234, 1) -> "123.4", (-5, 2) -> "-0.05" */
+size_t fixfmt_fixed(char *out, size_t len, int32_t value, uint8_t decimals);
+
+/* Decimal degrees rounded to `decimals` digits (0..7), e.g. "49.842130" */
+size_t fixfmt_deg(char *out, size_t len, int32_t deg_e7, uint8_t decimals);
+
+/* Degrees and decimal minutes with hemisphere letter, e.g. "49°50.528' N".
+   pos / neg are the letters for >= 0 and < 0 ('N'/'S' or 'E'/'W'). */
+size_t fixfmt_dm(char *out, size_t len, int32_t deg_e7, char pos, char neg);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FIXFMT_H */
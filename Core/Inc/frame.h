@@ -0,0 +1,63 @@
+#ifndef FRAME_H
+#define FRAME_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stddef.h>
+
+/* Binary framing for the radio link.
+
+   Frame layout:
+     SYNC (0xA5) | LEN | TYPE | PAYLOAD (LEN bytes) | CRC16 (LSB first)
+   CRC-16/CCITT-FALSE (poly 0x1021, init 0xFFFF) over LEN, TYPE and PAYLOAD.
+
+   The largest frame is 58 bytes, one E32 air sub-packet, so a frame is never
+   split on the air and always arrives inside one received packet. The parser
+   therefore scans one packet at a time and keeps nothing between packets: a
+   SYNC byte whose length, CRC or end does not check out is counted as an
+   error and the scan goes on from the byte after it, so a stray 0xA5 in
+   front of a frame does not swallow the frame. */
+
+#define FRAME_SYNC        0xA5
+#define FRAME_OVERHEAD    5
+#define FRAME_MAX_PAYLOAD (58 - FRAME_OVERHEAD)
+#define FRAME_MAX_SIZE    (FRAME_MAX_PAYLOAD + FRAME_OVERHEAD)
+
+/* Frame types used by this firmware */
+#define FRAME_TYPE_TEXT   0x01  /* payload is one line of text, no terminator */
+#define FRAME_TYPE_GPS    0x02  /* payload is a gps_codec.h position report */
+
+uint16_t frame_crc16(uint16_t crc, const uint8_t *data, size_t len);
+
+/* Build a frame into out. Returns the frame size, or 0 if len exceeds
+   FRAME_MAX_PAYLOAD or out is too small. */
+size_t frame_encode(uint8_t type, const uint8_t *payload, uint8_t len, uint8_t *out, size_t out_size);
+
+typedef struct {
+    const uint8_t *data;      /* packet being scanned */
+    size_t size;
+    size_t pos;               /* next byte to look at */
+    uint8_t len;              /* last frame found: payload length, */
+    uint8_t type;             /* type */
+    const uint8_t *payload;   /* and payload, inside data */
+    uint32_t crc_errors;      /* SYNC bytes dropped for a bad CRC, length or end */
+} frame_parser_t;
+
+/* Start scanning a packet. crc_errors carries over; the packet must stay
+   valid while frame_parser_next() is called. Zero-initialise the parser
+   before the first packet. */
+void frame_parser_packet(frame_parser_t *p, const uint8_t *data, size_t size);
+
+/* Find the next valid frame of the packet. Returns 1 with type, len and
+   payload set, 0 at the end of the packet. Bytes outside frames are
+   skipped. */
+uint8_t frame_parser_next(frame_parser_t *p);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FRAME_H */
@@ -0,0 +1,62 @@
+#ifndef GPS_CODEC_H
+#define GPS_CODEC_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stddef.h>
+
+/* Compact position reports, the payload of FRAME_TYPE_GPS frames.
+
+   Coordinates travel as int32 in 1e-7 degree (about 1 cm, beyond what a
+   float can hold for longitude) and altitude as int16 decimeters.
+
+   Report layout, multi-byte fields LSB first:
+     key:   [seq]        lat:int32 lon:int32 alt:int16   (11 bytes)
+     delta: [0x80 | seq] dlat dlon dalt as zigzag varints (typ. 4..7 bytes)
+   seq is a 7-bit counter. A delta applies to the report with the previous
+   seq only, so after a lost report the decoder ignores deltas until the next
+   key report. The encoder sends a key report every GPS_CODEC_KEY_INTERVAL
+   reports, and whenever a delta would not be smaller.
+
+   This board only receives reports (main.c decodes FRAME_TYPE_GPS frames);
+   gps_encode() is the sending node's half. */
+
+#ifndef GPS_CODEC_KEY_INTERVAL
+#define GPS_CODEC_KEY_INTERVAL 16
+#endif
+
+#define GPS_CODEC_KEY_SIZE 11
+#define GPS_CODEC_MAX_SIZE GPS_CODEC_KEY_SIZE
+
+typedef struct {
+    int32_t lat_e7;
+    int32_t lon_e7;
+    int16_t alt_dm;
+} gps_fix_t;
+
+/* Per-link state, one for the sending and one for the receiving side */
+typedef struct {
+    gps_fix_t ref;      /* last fix sent / received */
+    uint8_t seq;        /* seq of that fix */
+    uint8_t valid;      /* ref holds a fix */
+    uint8_t since_key;  /* deltas sent since the last key report */
+} gps_codec_t;
+
+void gps_codec_init(gps_codec_t *c);
+
+/* Encode fix into out (at least GPS_CODEC_MAX_SIZE bytes). Returns the
+   report size, 0 if out is too small. */
+size_t gps_encode(gps_codec_t *c, const gps_fix_t *fix, uint8_t *out, size_t out_size);
+
+/* Decode a report into fix. Returns 1 on success, 0 for a malformed report
+   or a delta that does not follow the last decoded fix. */
+uint8_t gps_decode(gps_codec_t *c, const uint8_t *in, size_t len, gps_fix_t *fix);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* GPS_CODEC_H */
@@ -0,0 +1,51 @@
+#ifndef MSGLOG_H
+#define MSGLOG_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stddef.h>
+
+/* Received-message log: a fixed ring of the last MSGLOG_DEPTH messages with
+   their HAL_GetTick() time, shown on the console as "MM:SS text" lines.
+
+   A new message is appended to the console, so thanks to the hardware scroll
+   only the rows it lands on are redrawn. The stamp takes 6 of the 21
+   columns: up to 15 characters fit one row (framebuffer mode: 3 I2C
+   transactions, 136 bytes per message), longer text wraps onto a second row
+   (5 transactions, 270 bytes). Figures from tests/host/test_msglog.c. */
+
+#ifndef MSGLOG_DEPTH
+#define MSGLOG_DEPTH 16
+#endif
+
+/* Longest stored message, including the terminating 0 */
+#ifndef MSGLOG_TEXT_MAX
+#define MSGLOG_TEXT_MAX 32
+#endif
+
+typedef struct {
+    uint32_t tick;
+    char text[MSGLOG_TEXT_MAX];
+} msglog_entry_t;
+
+/* Store text (cut to MSGLOG_TEXT_MAX - 1 characters) and show it */
+void msglog_add(const char *text);
+
+/* Entries stored, up to MSGLOG_DEPTH */
+uint16_t msglog_count(void);
+
+/* Entry age messages before the newest (0 = newest), NULL if not stored */
+const msglog_entry_t *msglog_get(uint16_t age);
+
+/* Write the stored messages through out, oldest first, one "MM:SS text\n"
+   line each (the E32 "#log" report) */
+void msglog_report(void (*out)(const char *line));
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MSGLOG_H */
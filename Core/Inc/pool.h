@@ -0,0 +1,84 @@
+#ifndef POOL_H
+#define POOL_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stddef.h>
+
+/* Fixed-block memory pool, the replacement for malloc in this firmware.
+
+   A pool hands out blocks of one size from static storage. Allocation and
+   release are O(1) (a free list threaded through the unused blocks), never
+   fragment, and are safe from both interrupt and main loop context. An
+   exhausted pool returns NULL instead of growing.
+
+   Usage:
+       POOL_STORAGE(packet_storage, 64, 4);
+       static pool_t packet_pool;
+       pool_init(&packet_pool, packet_storage, 64, 4);
+       uint8_t *buf = pool_alloc(&packet_pool);
+       ...
+       pool_free(&packet_pool, buf);
+
+   Building with the NO_HEAP option (CMake -DNO_HEAP=ON) removes the newlib
+   heap: the linker reserves no heap, _sbrk is not compiled and any call to
+   malloc, calloc or realloc fails the link. */
+
+/* Check in pool_free() that the block is not already on the free list. A
+   block freed twice would otherwise be handed out to two owners. The walk
+   is O(count) with interrupts off, so it is on by default only in debug
+   builds; without it pool_free() still refuses a free when no block is in
+   use. */
+#ifndef POOL_CHECK_FREE
+#ifdef DEBUG
+#define POOL_CHECK_FREE 1
+#else
+#define POOL_CHECK_FREE 0
+#endif
+#endif
+
+/* Words per block: block_size rounded up, at least room for the free-list
+   link */
+#define POOL_BLOCK_WORDS(block_size) \
+    ((((block_size) < sizeof(void *) ? sizeof(void *) : (size_t)(block_size)) + 3u) / 4u)
+
+/* Word-aligned static storage for count blocks of block_size bytes */
+#define POOL_STORAGE(name, block_size, count) \
+    static uint32_t name[(count) * POOL_BLOCK_WORDS(block_size)]
+
+typedef struct {
+    void *free_list;
+    uint8_t *storage;
+    uint16_t block_size;  /* bytes between blocks, a multiple of 4 */
+    uint16_t count;
+    uint16_t used;
+    uint16_t peak;        /* highest used since pool_init() */
+    uint32_t failures;    /* pool_alloc() calls that found the pool empty */
+    uint32_t bad_frees;   /* pool_free() calls refused, see pool_free() */
+} pool_t;
+
+/* storage must hold count * POOL_BLOCK_WORDS(block_size) words */
+void pool_init(pool_t *pool, void *storage, size_t block_size, uint16_t count);
+
+/* A free block, or NULL when all count blocks are in use */
+void *pool_alloc(pool_t *pool);
+
+/* Return a block from pool_alloc(). NULL is ignored. Pointers that are not
+   a block of this pool, a free while no block is in use and, with
+   POOL_CHECK_FREE, a block that is already free are refused and counted in
+   pool_bad_frees(). */
+void pool_free(pool_t *pool, void *block);
+
+uint16_t pool_used(const pool_t *pool);
+uint16_t pool_peak(const pool_t *pool);
+uint32_t pool_failures(const pool_t *pool);
+uint32_t pool_bad_frees(const pool_t *pool);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* POOL_H */
@@ -0,0 +1,58 @@
+#ifndef PROF_H
+#define PROF_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stddef.h>
+
+/* Hot-path profiler. On the target the time base is the Cortex-M3 DWT cycle
+   counter (CYCCNT, CPU cycles); on a host build it is clock_gettime
+   (nanoseconds). Every probe keeps count / min / max / total in a static
+   table that prof_dump() prints as text.
+
+   With PROF_ENABLE = 0 (default) all PROF_* macros expand to nothing.
+
+   Usage inside one function:
+       PROF_BEGIN(PROF_SSD1306_DATA);
+       ...
+       PROF_END(PROF_SSD1306_DATA);
+   BEGIN and END must be in the same scope; END must run on every path. */
+#ifndef PROF_ENABLE
+#define PROF_ENABLE 0
+#endif
+
+typedef enum {
+    PROF_SSD1306_DATA = 0,   /* ssd1306_data(): blocking data transfer */
+    PROF_SSD1306_WINDOW,     /* ssd1306_set_window(): cursor / window setup */
+    PROF_SSD1306_GLYPH,      /* glyph column conversion into page bytes */
+    PROF_SSD1306_FLUSH,      /* ssd1306_flush() */
+    PROF_E32_RX_EVENT,       /* USART2 receive event callback */
+    PROF_COUNT
+} prof_id_t;
+
+#if PROF_ENABLE
+void prof_init(void);
+uint32_t prof_now(void);
+void prof_record(prof_id_t id, uint32_t elapsed);
+void prof_reset(void);
+/* Write the table through out, one line per probe that fired:
+   name count min max mean, in cycles (target) or ns (host) */
+void prof_dump(void (*out)(const char *line));
+
+#define PROF_INIT()      prof_init()
+#define PROF_BEGIN(id)   uint32_t prof_t0_##id = prof_now()
+#define PROF_END(id)     prof_record((id), prof_now() - prof_t0_##id)
+#else
+#define PROF_INIT()      ((void)0)
+#define PROF_BEGIN(id)   ((void)0)
+#define PROF_END(id)     ((void)0)
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PROF_H */
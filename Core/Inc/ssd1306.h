@@ -9,6 +9,7 @@ extern "C" {
 #include <stdint.h>
 #include <stddef.h>
 #include "stm32f1xx_hal.h" /* change to your MCU family HAL header if required */
+#include "ssd1306_fonts.h"
 
 /* I2C handle used by implementation (externally defined in your project) */
 extern I2C_HandleTypeDef hi2c1;
@@ -18,9 +19,11 @@ extern I2C_HandleTypeDef hi2c1;
 #define SSD1306_ADDR (0x3C << 1)
 #endif
 
-/* Configurable transport parameters (override before including this header) */
+/* Configurable transport parameters (override before including this header).
+   SSD1306_I2C_CHUNK_SIZE caps the payload of one blocking data transaction;
+   0 sends every ssd1306_data() call, up to a full frame, as one transaction. */
 #ifndef SSD1306_I2C_CHUNK_SIZE
-#define SSD1306_I2C_CHUNK_SIZE 32
+#define SSD1306_I2C_CHUNK_SIZE 0
 #endif
 
 #ifndef SSD1306_I2C_TIMEOUT_MS
@@ -31,17 +34,31 @@ extern I2C_HandleTypeDef hi2c1;
 #define SSD1306_I2C_RETRIES 2
 #endif
 
-/* --- 5x8 font (provided in source) ------------------------------------- */
-#define FONT_FIRST_CHAR 32
-#define FONT_COUNT 96
-extern const uint8_t font5x8[FONT_COUNT][5];
+/* Asynchronous transport: data and framebuffer flushes are streamed by the
+   I2C1 TX DMA channel (DMA1 Channel 6) while the CPU keeps running. Requires
+   hi2c1 to be linked to a DMA handle and the I2C1 event/error and DMA
+   interrupts to be enabled (see stm32f1xx_hal_msp.c). */
+#ifndef SSD1306_USE_DMA
+#define SSD1306_USE_DMA 1
+#endif
+
+/* Transport statistics: count I2C transactions and bytes sent to the panel
+   (see ssd1306_stats_get() and ssd1306_bench_run()). Off by default. */
+#ifndef SSD1306_USE_STATS
+#define SSD1306_USE_STATS 0
+#endif
 
-/* --- 7x10 custom font (provided in source) ------------------------------ */
-#define FONT7X10_FIRST_CHAR 32
-#define FONT7X10_COUNT 96
-#define FONT7X10_ROWS 10
-#define FONT7X10_COLS 7
-extern const uint16_t Font7x10[]; /* layout: FONT7X10_ROWS uint16_t per glyph */
+/* Panel geometry: 128 columns x 8 pages (64 rows) */
+#define SSD1306_WIDTH 128
+#define SSD1306_PAGES 8
+
+/* RAM framebuffer mode. When enabled, drawing calls only update a 1 KB copy of
+   the display RAM and ssd1306_flush() pushes the column range of every page
+   touched since the previous flush. When disabled, drawing goes straight to
+   the panel and ssd1306_flush() is a no-op. */
+#ifndef SSD1306_USE_FRAMEBUFFER
+#define SSD1306_USE_FRAMEBUFFER 1
+#endif
 
 /* --- API ----------------------------------------------------------------
    Notes:
@@ -53,27 +70,142 @@ extern const uint16_t Font7x10[]; /* layout: FONT7X10_ROWS uint16_t per glyph */
 
 /* Low level command / data primitives */
 HAL_StatusTypeDef ssd1306_command(uint8_t cmd);
-HAL_StatusTypeDef ssd1306_data(uint8_t *data, uint16_t size);
+/* Send n command bytes (opcodes and their arguments) in one I2C transfer */
+HAL_StatusTypeDef ssd1306_commands(const uint8_t *cmds, size_t n);
+/* Send size bytes of display data, transmitted in place (no copy) */
+HAL_StatusTypeDef ssd1306_data(const uint8_t *data, uint16_t size);
+
+#if SSD1306_USE_DMA
+/* Completion callback of an asynchronous transfer, called from interrupt
+   context with HAL_OK or the HAL error that aborted the transfer. */
+typedef void (*ssd1306_done_cb_t)(HAL_StatusTypeDef status);
+
+/* Start a background data transfer; data must stay valid until completion.
+   Returns HAL_BUSY if a previous transfer is still in flight. */
+HAL_StatusTypeDef ssd1306_data_async(const uint8_t *data, uint16_t size);
+
+/* Non-zero while an asynchronous transfer is in flight. Blocking calls wait
+   for it to finish before touching the bus. */
+uint8_t ssd1306_busy(void);
+
+void ssd1306_set_done_callback(ssd1306_done_cb_t cb);
+#endif
 
 /* Cursor control */
 void ssd1306_set_cursor(uint8_t page, uint8_t col);
 
+/* Restrict horizontal-mode addressing to columns col0..col1 and pages
+   page0..page1 (0x21/0x22) in a single command transaction. Data bytes then
+   fill the window column by column, wrapping to the next page at col1. */
+HAL_StatusTypeDef ssd1306_set_window(uint8_t col0, uint8_t col1, uint8_t page0, uint8_t page1);
+
+/* Hardware vertical scroll: RAM row line (0..63) is shown at the top of the
+   panel and the rows wrap around. Drawing coordinates stay RAM coordinates.
+   In framebuffer mode the command is sent by the first flush started after
+   this call, after its pixel data, so rows scrolled into view are already
+   up to date. ssd1306_clear()
+   resets the start line to 0. */
+HAL_StatusTypeDef ssd1306_set_start_line(uint8_t line);
+uint8_t ssd1306_get_start_line(void);
+
+/* Write a width x pages block of page-packed bytes (page-major: all columns of
+   the first page, then the next page) at pixel column col, page page. */
+HAL_StatusTypeDef ssd1306_write_block(uint8_t col, uint8_t page, uint8_t width, uint8_t pages,
+                                      const uint8_t *data);
+
 /* Basic display control */
 void ssd1306_init(void);
 HAL_StatusTypeDef ssd1306_clear(void);
 
+/* Clear w x h pixels at pixel column x, row y (clipped to the panel). In
+   framebuffer mode only those pixels change. In direct mode the display RAM
+   cannot be read back, so whole bytes are cleared: rows y..y+h-1 are rounded
+   out to page boundaries. Either way the cost is one window of the covered
+   columns and pages, not a full screen. */
+HAL_StatusTypeDef ssd1306_clear_rect(uint8_t x, uint8_t y, uint8_t w, uint8_t h);
+
+/* Push pending framebuffer changes to the panel (one span per dirty page) */
+HAL_StatusTypeDef ssd1306_flush(void);
+
+/* Same as ssd1306_flush() but streamed in the background: returns as soon as
+   the first span is started (or HAL_BUSY if a transfer is in flight). Drawing
+   during the flush is allowed; changed spans are picked up by the next one.
+   With nothing to send it returns HAL_OK without starting a transfer or
+   calling the done callback. Without SSD1306_USE_DMA this is the blocking
+   ssd1306_flush(). */
+HAL_StatusTypeDef ssd1306_flush_async(void);
+
+#if SSD1306_USE_FRAMEBUFFER
+/* Read-only view of the framebuffer: SSD1306_PAGES rows of SSD1306_WIDTH
+   bytes, bit n of a byte = pixel row page * 8 + n */
+const uint8_t *ssd1306_framebuffer(void);
+
+/* Write the framebuffer as a binary PBM (P4) image through out, e.g. to a
+   UART for screenshots or to compare against reference images. out gets the
+   header first, then one 16-byte pixel row per call. */
+typedef void (*ssd1306_write_fn_t)(const uint8_t *buf, size_t len);
+void ssd1306_dump_pbm(ssd1306_write_fn_t out);
+#endif
+
+#if SSD1306_USE_STATS
+/* Bus cost counters since the last reset. payload_bytes counts the control
+   and data/command bytes; the address byte of each transaction is implied. */
+typedef struct {
+    uint32_t transactions;
+    uint32_t payload_bytes;
+    uint32_t errors;
+} ssd1306_stats_t;
+
+void ssd1306_stats_get(ssd1306_stats_t *stats);
+void ssd1306_stats_reset(void);
+/* Modeled time on the wire in microseconds at bus_hz: 9 clocks per byte
+   (8 bits + ACK) plus address byte, START and STOP per transaction */
+uint32_t ssd1306_stats_bus_time_us(const ssd1306_stats_t *stats, uint32_t bus_hz);
+
+/* Run the standard rendering workloads (ssd1306_bench.c) and write one CSV
+   line per workload through out:
+   workload,transactions,payload_bytes,us_100k,us_400k,us_1000k
+   Transactions and bytes are counted; the us_* columns are the modeled wire
+   time of those counts (ssd1306_stats_bus_time_us), not a measurement. The
+   display content is overwritten. On the target the E32 command "#bench"
+   runs it; tests/host runs it against the panel model and keeps the CSV. */
+void ssd1306_bench_run(void (*out)(const char *line));
+#endif
+
+/* Generic font renderer. x is the pixel column, y the pixel row (0..63, not
+   limited to page boundaries). Each glyph cell (advance x font height) is
+   drawn opaque; in framebuffer mode pixels outside the cell are preserved,
+   in direct mode the rest of every touched page is cleared. Text is clipped
+   at the right and bottom edges. In direct mode ssd1306_draw_text() composes
+   the whole string and sends it with one window setup and one data stream. */
+HAL_StatusTypeDef ssd1306_draw_char(const ssd1306_font_t *font, uint8_t x, uint8_t y, char c);
+HAL_StatusTypeDef ssd1306_draw_text(const ssd1306_font_t *font, uint8_t x, uint8_t y, const char *s);
+/* Same for at most the first n characters of s */
+HAL_StatusTypeDef ssd1306_draw_textn(const ssd1306_font_t *font, uint8_t x, uint8_t y, const char *s,
+                                     size_t n);
+uint8_t ssd1306_glyph_advance(const ssd1306_font_t *font, char c);
+uint16_t ssd1306_text_width(const ssd1306_font_t *font, const char *s);
+
 /* 5x8 font helpers (each glyph 5 bytes, stored in font5x8) */
 HAL_StatusTypeDef ssd1306_write_char(uint8_t col, uint8_t page, char c);
 HAL_StatusTypeDef ssd1306_write_string(uint8_t col, uint8_t page, const char *s);
 
-/* 7x10 custom font helpers (Font7x10, converts glyphs to two pages) */
+/* 7x10 custom font helpers (font7x10_pages, glyphs occupy two pages) */
 HAL_StatusTypeDef ssd1306_write_char_from_Font7x10cust(uint8_t col, uint8_t page, char c);
 HAL_StatusTypeDef ssd1306_write_string_7x10cust(uint8_t start_col, uint8_t page, const char *s);
 
-/* Utility (optional) - exposes internal helper used by 7x10 conversion */
-int ssd1306_font7x10_find_bit_offset(void);
-
+/* Telemetry view: latitude, longitude (degrees and decimal minutes) and
+   altitude as three right-aligned 7x10 lines on pages 0-1, 2-3 and 4-5.
+   Only the cells that differ from the previous update are redrawn, so a new
+   GPS fix usually costs a few glyphs. Coordinates are in 1e-7 degree, the
+   altitude in decimeters. The driver does not know when another view has
+   drawn over these pages (ssd1306_clear() included): whoever switches to
+   this view calls Display_ResetCoordinates() first to force a full redraw.
+   With the framebuffer a full view is 776 payload bytes and the bench update
+   96 (tests/host, ssd1306_bench). */
+HAL_StatusTypeDef Display_ShowCoordinatesE7(int32_t lat_e7, int32_t lon_e7, int32_t alt_dm);
 void Display_ShowCoordinates(float lat, float lon, float alt);
+void Display_ResetCoordinates(void);
 
 
 /* If you want to compile the implementation as C++ code, define this to 1 to
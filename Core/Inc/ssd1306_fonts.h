@@ -0,0 +1,59 @@
+#ifndef SSD1306_FONTS_H
+#define SSD1306_FONTS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Font tables and descriptors for the SSD1306 driver. This header has no HAL
+   dependency so the host-side generator (tools/fontgen) can use it too. */
+#include <stdint.h>
+#include <stddef.h>
+
+/* --- 5x8 font (provided in ssd1306_fonts.c) ------------------------------ */
+#define FONT_FIRST_CHAR 32
+#define FONT_COUNT 96
+extern const uint8_t font5x8[FONT_COUNT][5];
+
+/* --- 7x10 custom font (generated at build time by tools/fontgen) --------- */
+#define FONT7X10_FIRST_CHAR 32
+#define FONT7X10_COUNT 96
+#define FONT7X10_ROWS 10
+#define FONT7X10_COLS 7
+#define FONT7X10_GLYPH_BYTES (2 * (FONT7X10_COLS + 1)) /* two pages incl. spacing column */
+extern const uint8_t font7x10_pages[FONT7X10_COUNT][FONT7X10_GLYPH_BYTES];
+
+/* --- Font descriptor -----------------------------------------------------
+   Glyph bitmaps are page-packed columns (bit 0 = top row), stored page-major
+   per glyph: width bytes for rows 0..7, then width bytes for rows 8..15.
+   A glyph advances the pen by its width plus `spacing` blank columns.
+   Fixed-width fonts leave widths/offsets NULL: every glyph is `width`
+   columns and glyph i starts at i * width * pages.
+-------------------------------------------------------------------------*/
+typedef struct {
+    uint8_t height;           /* rows, 1..16 */
+    uint8_t width;            /* fixed width, or widest glyph if proportional */
+    uint8_t spacing;          /* blank columns after each glyph */
+    uint8_t first_char;
+    uint8_t count;
+    const uint8_t *widths;    /* per-glyph width in columns, or NULL */
+    const uint16_t *offsets;  /* per-glyph byte offset into bitmaps, or NULL */
+    const uint8_t *bitmaps;
+} ssd1306_font_t;
+
+#define SSD1306_FONT_PAGES(font) ((uint8_t)(((font)->height + 7) / 8))
+
+/* Fixed 5x8 (6 px advance) and 7x10 (8 px advance) fonts */
+extern const ssd1306_font_t ssd1306_font_5x8;
+extern const ssd1306_font_t ssd1306_font_7x10;
+
+/* Proportional variants of the same glyphs (digits keep a common width so
+   numeric fields stay aligned) */
+extern const ssd1306_font_t ssd1306_font_5x8p;
+extern const ssd1306_font_t ssd1306_font_7x10p;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SSD1306_FONTS_H */
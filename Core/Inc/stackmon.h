@@ -0,0 +1,48 @@
+#ifndef STACKMON_H
+#define STACKMON_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stddef.h>
+
+/* Stack high-water mark by stack painting.
+
+   stackmon_paint(), called first thing in main(), fills the free RAM between
+   the heap reservation and the current stack pointer with STACKMON_PATTERN.
+   The stack grows down into it; the lowest word that no longer holds the
+   pattern is the deepest the stack has been. Heap growth past the
+   reservation (_sbrk) is taken out of the scan, so it is not counted as
+   stack.
+
+   Sizes come from the linker script: _end (end of .bss), _Min_Heap_Size,
+   _Min_Stack_Size and _estack. */
+
+#ifndef STACKMON_PATTERN
+#define STACKMON_PATTERN 0xC5C5C5C5u
+#endif
+
+void stackmon_paint(void);
+
+/* Deepest stack use since stackmon_paint(), in bytes */
+uint32_t stackmon_stack_used(void);
+uint32_t stackmon_stack_reserved(void);
+
+/* Heap handed out by _sbrk (malloc, printf buffers), in bytes */
+uint32_t stackmon_heap_used(void);
+uint32_t stackmon_heap_reserved(void);
+
+/* Never-touched RAM between the heap and the deepest stack */
+uint32_t stackmon_headroom(void);
+
+/* Write the figures through out, one line each:
+   stack used / reserved, heap used / reserved, headroom */
+void stackmon_report(void (*out)(const char *line));
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* STACKMON_H */
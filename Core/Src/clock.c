@@ -0,0 +1,121 @@
+#include "clock.h"
+#include "ssd1306.h"
+#include "e32.h"
+
+/* External HAL handles from the main project */
+extern I2C_HandleTypeDef hi2c1;
+extern UART_HandleTypeDef huart2;
+
+/* SystemClock_Config() leaves the core on HSI without PLL */
+static clock_profile_t clock_current = CLOCK_PROFILE_HSI_8MHZ;
+
+/* Run SYSCLK from HSI with all buses undivided and no wait states */
+static HAL_StatusTypeDef clock_select_hsi(void)
+{
+    RCC_ClkInitTypeDef clk = {0};
+    clk.ClockType = RCC_CLOCKTYPE_HCLK | RCC_CLOCKTYPE_SYSCLK | RCC_CLOCKTYPE_PCLK1 | RCC_CLOCKTYPE_PCLK2;
+    clk.SYSCLKSource = RCC_SYSCLKSOURCE_HSI;
+    clk.AHBCLKDivider = RCC_SYSCLK_DIV1;
+    clk.APB1CLKDivider = RCC_HCLK_DIV1;
+    clk.APB2CLKDivider = RCC_HCLK_DIV1;
+    return HAL_RCC_ClockConfig(&clk, FLASH_LATENCY_0);
+}
+
+/* Stop the PLL and the HSE (SYSCLK must already be on HSI) */
+static HAL_StatusTypeDef clock_stop_pll(void)
+{
+    RCC_OscInitTypeDef osc = {0};
+    osc.OscillatorType = RCC_OSCILLATORTYPE_HSE;
+    osc.HSEState = RCC_HSE_OFF;
+    osc.PLL.PLLState = RCC_PLL_OFF;
+    return HAL_RCC_OscConfig(&osc);
+}
+
+/* Start the PLL of profile p and switch SYSCLK to it */
+static HAL_StatusTypeDef clock_start_pll(clock_profile_t p)
+{
+    RCC_OscInitTypeDef osc = {0};
+    RCC_ClkInitTypeDef clk = {0};
+
+    if (p == CLOCK_PROFILE_HSE_72MHZ) {
+        osc.OscillatorType = RCC_OSCILLATORTYPE_HSE;
+        osc.HSEState = RCC_HSE_ON;
+        osc.HSEPredivValue = RCC_HSE_PREDIV_DIV1;
+        osc.PLL.PLLSource = RCC_PLLSOURCE_HSE;
+        osc.PLL.PLLMUL = RCC_PLL_MUL9;
+    } else {
+        osc.OscillatorType = RCC_OSCILLATORTYPE_NONE;
+        osc.PLL.PLLSource = RCC_PLLSOURCE_HSI_DIV2;
+        osc.PLL.PLLMUL = RCC_PLL_MUL16;
+    }
+    osc.PLL.PLLState = RCC_PLL_ON;
+    HAL_StatusTypeDef st = HAL_RCC_OscConfig(&osc);
+    if (st != HAL_OK) return st;
+
+    clk.ClockType = RCC_CLOCKTYPE_HCLK | RCC_CLOCKTYPE_SYSCLK | RCC_CLOCKTYPE_PCLK1 | RCC_CLOCKTYPE_PCLK2;
+    clk.SYSCLKSource = RCC_SYSCLKSOURCE_PLLCLK;
+    clk.AHBCLKDivider = RCC_SYSCLK_DIV1;
+    clk.APB1CLKDivider = RCC_HCLK_DIV2;
+    clk.APB2CLKDivider = RCC_HCLK_DIV1;
+    return HAL_RCC_ClockConfig(&clk, FLASH_LATENCY_2);
+}
+
+/* Recompute the PCLK1-derived peripheral timings. HAL_I2C_Init() on an
+   initialized handle only reprograms the registers (no MspInit). USART2
+   keeps receiving: only its baud rate divider is rewritten. */
+static void clock_retime_peripherals(void)
+{
+    if (hi2c1.State != HAL_I2C_STATE_RESET) {
+        if (HAL_I2C_Init(&hi2c1) != HAL_OK) Error_Handler();
+    }
+    if (huart2.gState != HAL_UART_STATE_RESET) {
+        huart2.Instance->BRR = UART_BRR_SAMPLING16(HAL_RCC_GetPCLK1Freq(), huart2.Init.BaudRate);
+    }
+}
+
+HAL_StatusTypeDef clock_set_profile(clock_profile_t p)
+{
+    if (p >= CLOCK_PROFILE_COUNT) return HAL_ERROR;
+    if (p == clock_current) return HAL_OK;
+
+#if SSD1306_USE_DMA
+    /* The I2C peripheral is reprogrammed below */
+    uint32_t start = HAL_GetTick();
+    while (ssd1306_busy()) {
+        if ((HAL_GetTick() - start) > SSD1306_I2C_TIMEOUT_MS) return HAL_BUSY;
+    }
+#endif
+    /* USART2 is re-timed below: the E32 queue must be sent and its last
+       character out at the old baud rate. Nothing refills the queue from
+       interrupts, so it stays empty until we return. */
+    if (huart2.gState != HAL_UART_STATE_RESET) {
+        uint32_t start_tx = HAL_GetTick();
+        while (E32_TxPending() > 0 || !__HAL_UART_GET_FLAG(&huart2, UART_FLAG_TC)) {
+            if ((HAL_GetTick() - start_tx) > CLOCK_UART_DRAIN_MS) return HAL_BUSY;
+        }
+    }
+
+    /* The PLL cannot be reprogrammed while it drives SYSCLK */
+    HAL_StatusTypeDef st = clock_select_hsi();
+    if (st == HAL_OK) st = clock_stop_pll();
+    if (st == HAL_OK) {
+        clock_current = CLOCK_PROFILE_HSI_8MHZ;
+        if (p != CLOCK_PROFILE_HSI_8MHZ) {
+            st = clock_start_pll(p);
+            if (st == HAL_OK) {
+                clock_current = p;
+            } else {
+                clock_select_hsi();
+                clock_stop_pll();
+            }
+        }
+    }
+
+    clock_retime_peripherals();
+    return st;
+}
+
+clock_profile_t clock_get_profile(void)
+{
+    return clock_current;
+}
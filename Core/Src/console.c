@@ -0,0 +1,142 @@
+#include "console.h"
+#include <string.h>
+
+/* Cell rows indexed by display page (RAM row), not by screen row */
+static char console_cells[CONSOLE_ROWS][CONSOLE_COLS];
+
+static uint8_t console_top;     /* page shown at the top of the screen */
+static uint8_t console_row;     /* cursor screen row, 0..CONSOLE_ROWS-1 */
+static uint8_t console_col;
+static uint8_t console_newline; /* '\n' seen, next character starts a new row */
+
+/* Cells of the cursor row changed since they were last drawn (seg0 > seg1
+   when none). A stale row still shows the line it had before it scrolled
+   in and is redrawn in full. */
+static uint8_t console_seg0 = 0xFF;
+static uint8_t console_seg1;
+static uint8_t console_stale;
+
+static uint8_t console_hidden;
+
+static uint8_t console_page(void)
+{
+    return (uint8_t)((console_top + console_row) % CONSOLE_ROWS);
+}
+
+/* Draw the pending cells of the cursor row, then apply a pending scroll */
+static void console_commit(void)
+{
+    uint8_t page = console_page();
+
+    if (console_hidden) {
+        /* Everything is redrawn by console_set_visible(1) */
+        console_stale = 0;
+        console_seg0 = 0xFF;
+        console_seg1 = 0;
+        return;
+    }
+    if (console_stale) {
+        console_seg0 = 0;
+        console_seg1 = CONSOLE_COLS - 1;
+    }
+    if (console_seg0 <= console_seg1) {
+        ssd1306_draw_textn(&ssd1306_font_5x8, (uint8_t)(console_seg0 * CONSOLE_CELL_WIDTH),
+                           (uint8_t)(page * 8), &console_cells[page][console_seg0],
+                           (size_t)(console_seg1 - console_seg0 + 1));
+    }
+    if (console_stale) {
+        console_stale = 0;
+        ssd1306_set_start_line((uint8_t)(console_top * 8));
+    }
+    console_seg0 = 0xFF;
+    console_seg1 = 0;
+}
+
+static void console_next_row(void)
+{
+    console_commit();
+    console_col = 0;
+    console_newline = 0;
+
+    if (console_row < CONSOLE_ROWS - 1) {
+        console_row++;
+        return;
+    }
+
+    /* Scroll: the top page becomes the new bottom row */
+    console_top = (uint8_t)((console_top + 1) % CONSOLE_ROWS);
+    memset(console_cells[console_page()], ' ', CONSOLE_COLS);
+    console_stale = 1;
+}
+
+static void console_put(char c)
+{
+    if (c == '\n') {
+        if (console_newline) console_next_row(); /* empty line */
+        console_newline = 1;
+        return;
+    }
+    if (c == '\r') {
+        if (!console_newline) console_col = 0;
+        return;
+    }
+    if (c == '\b') {
+        if (console_col > 0 && !console_newline) console_col--;
+        return;
+    }
+    if ((uint8_t)c < 0x20) return;
+
+    if (console_newline || console_col >= CONSOLE_COLS) console_next_row();
+
+    uint8_t col = console_col++;
+    console_cells[console_page()][col] = c;
+    if (col < console_seg0) console_seg0 = col;
+    if (col > console_seg1) console_seg1 = col;
+}
+
+void console_clear(void)
+{
+    memset(console_cells, ' ', sizeof(console_cells));
+    console_top = 0;
+    console_row = 0;
+    console_col = 0;
+    console_newline = 0;
+    console_seg0 = 0xFF;
+    console_seg1 = 0;
+    console_stale = 0;
+    if (!console_hidden) ssd1306_clear();
+}
+
+void console_set_visible(uint8_t visible)
+{
+    if (!visible) {
+        console_hidden = 1;
+        return;
+    }
+    if (!console_hidden) return;
+
+    console_hidden = 0;
+    ssd1306_clear();
+    for (uint8_t page = 0; page < CONSOLE_ROWS; page++) {
+        ssd1306_draw_textn(&ssd1306_font_5x8, 0, (uint8_t)(page * 8), console_cells[page], CONSOLE_COLS);
+    }
+    ssd1306_set_start_line((uint8_t)(console_top * 8));
+}
+
+void console_write(const char *s, size_t n)
+{
+    if (s == NULL) return;
+    for (size_t i = 0; i < n; i++) console_put(s[i]);
+    console_commit();
+}
+
+void console_putc(char c)
+{
+    console_write(&c, 1);
+}
+
+void console_puts(const char *s)
+{
+    if (s == NULL) return;
+    console_write(s, strlen(s));
+}
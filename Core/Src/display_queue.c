@@ -0,0 +1,108 @@
+#include "display_queue.h"
+#include "console.h"
+#include "msglog.h"
+#include <string.h>
+
+#if (DISPLAY_QUEUE_SIZE & (DISPLAY_QUEUE_SIZE - 1)) != 0 || DISPLAY_QUEUE_SIZE > 128
+#error "DISPLAY_QUEUE_SIZE must be a power of two, at most 128"
+#endif
+
+/* Single-producer / single-consumer ring. head is written only by the
+   producer, tail only by the consumer; both are free-running and wrap at 256,
+   so head - tail is the fill level. A slot is published by the head update
+   and released by the tail update, each after a barrier that orders the slot
+   access before it. */
+static display_req_t display_queue_slots[DISPLAY_QUEUE_SIZE];
+static volatile uint8_t display_queue_head;
+static volatile uint8_t display_queue_tail;
+static volatile uint32_t display_queue_drops;
+
+uint8_t display_queue_post(const display_req_t *req)
+{
+    if (req == NULL) return 0;
+
+    uint8_t head = display_queue_head;
+    if ((uint8_t)(head - display_queue_tail) >= DISPLAY_QUEUE_SIZE) {
+        display_queue_drops++;
+        return 0;
+    }
+
+    display_queue_slots[head & (DISPLAY_QUEUE_SIZE - 1)] = *req;
+    display_queue_slots[head & (DISPLAY_QUEUE_SIZE - 1)].text[DISPLAY_QUEUE_TEXT_MAX - 1] = '\0';
+    __DMB();
+    display_queue_head = (uint8_t)(head + 1);
+    return 1;
+}
+
+uint8_t display_queue_post_clear(void)
+{
+    display_req_t req = { .type = DISPLAY_REQ_CLEAR };
+    return display_queue_post(&req);
+}
+
+uint8_t display_queue_post_text(const ssd1306_font_t *font, uint8_t x, uint8_t y, const char *text)
+{
+    display_req_t req = { .type = DISPLAY_REQ_TEXT, .x = x, .y = y, .font = font };
+    if (text != NULL) strncpy(req.text, text, sizeof(req.text) - 1);
+    return display_queue_post(&req);
+}
+
+uint8_t display_queue_post_console(const char *text)
+{
+    display_req_t req = { .type = DISPLAY_REQ_CONSOLE };
+    if (text != NULL) strncpy(req.text, text, sizeof(req.text) - 1);
+    return display_queue_post(&req);
+}
+
+uint8_t display_queue_post_log(const char *text)
+{
+    display_req_t req = { .type = DISPLAY_REQ_LOG };
+    if (text != NULL) strncpy(req.text, text, sizeof(req.text) - 1);
+    return display_queue_post(&req);
+}
+
+uint8_t display_queue_post_screen(const ssd1306_font_t *font, uint8_t x, uint8_t y, const char *text)
+{
+    display_req_t req = { .type = DISPLAY_REQ_SCREEN, .x = x, .y = y, .font = font };
+    if (text != NULL) strncpy(req.text, text, sizeof(req.text) - 1);
+    return display_queue_post(&req);
+}
+
+void display_queue_drain(void)
+{
+    uint8_t tail = display_queue_tail;
+
+    while (tail != display_queue_head) {
+        __DMB();
+        const display_req_t *req = &display_queue_slots[tail & (DISPLAY_QUEUE_SIZE - 1)];
+
+        switch (req->type) {
+            case DISPLAY_REQ_CLEAR:
+                ssd1306_clear();
+                break;
+            case DISPLAY_REQ_TEXT:
+                ssd1306_draw_text(req->font, req->x, req->y, req->text);
+                break;
+            case DISPLAY_REQ_CONSOLE:
+                console_puts(req->text);
+                console_putc('\n');
+                break;
+            case DISPLAY_REQ_LOG:
+                msglog_add(req->text);
+                break;
+            case DISPLAY_REQ_SCREEN:
+                ssd1306_clear();
+                ssd1306_draw_text(req->font, req->x, req->y, req->text);
+                break;
+        }
+
+        __DMB();
+        tail++;
+        display_queue_tail = tail;
+    }
+}
+
+uint32_t display_queue_dropped(void)
+{
+    return display_queue_drops;
+}
@@ -1,13 +1,37 @@
 #include "e32.h"
+#include "display_queue.h"
+#include "console.h"
+#include "msglog.h"
+#include "frame.h"
+#include "prof.h"
+#include "stackmon.h"
 #include <string.h>
 
-uint8_t LoRa_RX_Buffer[64];
+uint8_t LoRa_RX_Buffer[E32_RX_DMA_SIZE];
 char rx_line[RX_LINE_MAX];
 uint8_t rx_idx = 0;
 
+static E32_Mode e32_mode = E32_MODE_NORMAL;
+static volatile uint32_t e32_aux_rises = 0;  // фронтів AUX 0 → 1 (EXTI)
+
+static HAL_StatusTypeDef e32_wait_aux(uint32_t timeout)
+{
+    uint32_t start = HAL_GetTick();
+    while (!E32_IsReady())
+    {
+        if ((HAL_GetTick() - start) > timeout) return HAL_TIMEOUT;
+    }
+    return HAL_OK;
+}
+
 // --- Встановлюємо режим модуля ---
+// Після зміни M0/M1 модуль не одразу опускає AUX і тримає його низьким, поки
+// перемикається. Тому спершу чекаємо спаду AUX (або фронту, якщо спад був
+// коротший за опитування), а вже потім підйому.
 void E32_SetMode(E32_Mode mode)
 {
+    uint32_t rises = e32_aux_rises;
+    e32_mode = mode;
     switch(mode)
     {
         case E32_MODE_NORMAL:
@@ -27,7 +51,10 @@ void E32_SetMode(E32_Mode mode)
             HAL_GPIO_WritePin(E32_M1_PORT, E32_M1_PIN, GPIO_PIN_SET);
             break;
     }
-    HAL_Delay(50); // даємо час на переключення режиму
+    uint32_t start = HAL_GetTick();
+    while (E32_IsReady() && e32_aux_rises == rises && (HAL_GetTick() - start) < E32_MODE_SETTLE_MS) {}
+    e32_wait_aux(E32_CONFIG_TIMEOUT_MS);
+    HAL_Delay(2);  // новий режим діє через 2 мс після підйому AUX
 }
 
 // --- Перевірка готовності через AUX ---
@@ -36,65 +63,581 @@ uint8_t E32_IsReady(void)
     return (HAL_GPIO_ReadPin(E32_AUX_PORT, E32_AUX_PIN) == GPIO_PIN_SET);
 }
 
+// -------------------------
+// Передача: кільцевий буфер, DMA і AUX
+// -------------------------
+#if (E32_TX_RING_SIZE & (E32_TX_RING_SIZE - 1)) != 0
+#error "E32_TX_RING_SIZE must be a power of two"
+#endif
+
+// head пише лише головний цикл, tail рухає переривання після DMA
+static uint8_t e32_tx_ring[E32_TX_RING_SIZE];
+static volatile uint16_t e32_tx_head = 0;
+static volatile uint16_t e32_tx_tail = 0;
+static volatile uint16_t e32_tx_len = 0;      // байтів у DMA-передачі, 0 — UART вільний
+static volatile uint32_t e32_tx_dropped = 0;
+static volatile uint32_t e32_tx_errors = 0;
+
+// Запустити наступну частину, якщо UART вільний, є дані і модуль готовий.
+// Викликається з головного циклу (E32_Write, E32_Poll — повтор, якщо HAL
+// не прийняв передачу), завершення DMA та переривання AUX.
+static void e32_tx_kick(void)
+{
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+
+    uint16_t tail = e32_tx_tail;
+    uint16_t pending = (uint16_t)(e32_tx_head - tail);
+    if (e32_tx_len == 0 && pending > 0 && E32_IsReady())
+    {
+        uint16_t off = tail & (E32_TX_RING_SIZE - 1);
+        uint16_t n = pending;
+        if (n > E32_TX_RING_SIZE - off) n = E32_TX_RING_SIZE - off;  // до кінця кільця
+        if (n > E32_TX_CHUNK) n = E32_TX_CHUNK;
+        if (HAL_UART_Transmit_DMA(LORA_UART, &e32_tx_ring[off], n) == HAL_OK) e32_tx_len = n;
+    }
+
+    __set_PRIMASK(primask);
+}
+
+// Поставити len байтів у чергу. Повертає скільки поміщається в буфер,
+// решта відкидається і рахується в E32_TxDropped().
+uint16_t E32_Write(const uint8_t *data, uint16_t len)
+{
+    if (data == NULL) return 0;
+
+    uint16_t head = e32_tx_head;
+    uint16_t room = (uint16_t)(E32_TX_RING_SIZE - (uint16_t)(head - e32_tx_tail));
+    uint16_t n = (len > room) ? room : len;
+
+    for (uint16_t i = 0; i < n; i++, head++) {
+        e32_tx_ring[head & (E32_TX_RING_SIZE - 1)] = data[i];
+    }
+    if (n < len) e32_tx_dropped += (uint32_t)(len - n);
+
+    __DMB();
+    e32_tx_head = head;
+    e32_tx_kick();
+    return n;
+}
+
 // --- Відправка рядка ---
 void E32_SendString(char *str)
 {
-    while(!E32_IsReady()) HAL_Delay(5);
-    HAL_UART_Transmit(&huart2, (uint8_t*)str, strlen(str), HAL_MAX_DELAY);
+    if (str == NULL) return;
+    E32_Write((const uint8_t *)str, (uint16_t)strlen(str));
 }
 
 // --- Відправка одного байта ---
 void E32_SendByte(uint8_t data)
 {
-    while(!E32_IsReady()) HAL_Delay(5);
-    HAL_UART_Transmit(&huart2, &data, 1, HAL_MAX_DELAY);
+    E32_Write(&data, 1);
+}
+
+// Байтів у черзі, включно з тими, що зараз передаються
+uint16_t E32_TxPending(void)
+{
+    return (uint16_t)(e32_tx_head - e32_tx_tail);
+}
+
+uint32_t E32_TxDropped(void)
+{
+    return e32_tx_dropped;
+}
+
+uint32_t E32_TxErrors(void)
+{
+    return e32_tx_errors;
 }
-// Callback — викликається при кожному прийнятому байті
-uint8_t Packet[64];
-uint8_t idx = 0;
 
-void HAL_UART_RxCpltCallback(UART_HandleTypeDef *huart)
+// DMA передав частину — звільняємо її і пробуємо наступну
+void HAL_UART_TxCpltCallback(UART_HandleTypeDef *huart)
 {
-    if (huart->Instance == USART2)
+    if (huart->Instance != USART2) return;
+    e32_tx_tail = (uint16_t)(e32_tx_tail + e32_tx_len);
+    e32_tx_len = 0;
+    e32_tx_kick();
+}
+
+// AUX 0 → 1: модуль звільнив буфер
+void HAL_GPIO_EXTI_Callback(uint16_t GPIO_Pin)
+{
+    if (GPIO_Pin != E32_AUX_PIN) return;
+    e32_aux_rises++;
+    e32_tx_kick();
+}
+// -------------------------
+// Прийом: кільцевий буфер з пакетами по паузі
+// -------------------------
+#if (E32_RX_RING_SIZE & (E32_RX_RING_SIZE - 1)) != 0 || (E32_RX_MAX_PACKETS & (E32_RX_MAX_PACKETS - 1)) != 0
+#error "E32_RX_RING_SIZE and E32_RX_MAX_PACKETS must be powers of two"
+#endif
+
+// Байти: пише лише переривання (head), читає лише головний цикл (tail)
+static uint8_t e32_rx_ring[E32_RX_RING_SIZE];
+static volatile uint16_t e32_rx_head = 0;
+static volatile uint16_t e32_rx_tail = 0;
+
+// Довжини завершених пакетів, так само один писач і один читач
+static uint16_t e32_pkt_len[E32_RX_MAX_PACKETS];
+static volatile uint8_t e32_pkt_head = 0;
+static volatile uint8_t e32_pkt_tail = 0;
+
+static uint16_t e32_rx_pos = 0;      // скільки байтів LoRa_RX_Buffer вже забрали
+static uint16_t e32_rx_cur_len = 0;  // байтів у пакеті, що ще приймається
+static volatile uint32_t e32_rx_overruns = 0;
+static uint32_t e32_rx_truncated = 0;  // пакетів, довших за буфер читача
+
+// Запуск прийому (після MX_USART2_UART_Init)
+HAL_StatusTypeDef E32_StartReceive(void)
+{
+    e32_rx_pos = 0;
+#if E32_RX_USE_DMA
+    HAL_StatusTypeDef st = HAL_UARTEx_ReceiveToIdle_DMA(LORA_UART, LoRa_RX_Buffer, E32_RX_DMA_SIZE);
+    // Переривання половини буфера не потрібне: кільце і так забираємо по паузі/заповненню
+    if (st == HAL_OK) __HAL_DMA_DISABLE_IT(LORA_UART->hdmarx, DMA_IT_HT);
+    return st;
+#else
+    return HAL_UARTEx_ReceiveToIdle_IT(LORA_UART, LoRa_RX_Buffer, E32_RX_DMA_SIZE);
+#endif
+}
+
+static void e32_rx_push(const uint8_t *data, uint16_t len)
+{
+    uint16_t head = e32_rx_head;
+    for (uint16_t i = 0; i < len; i++) {
+        if ((uint16_t)(head - e32_rx_tail) >= E32_RX_RING_SIZE) {
+            e32_rx_overruns++;  // кільце повне: решту байтів втрачено
+            break;
+        }
+        e32_rx_ring[head & (E32_RX_RING_SIZE - 1)] = data[i];
+        head++;
+        e32_rx_cur_len++;
+    }
+    __DMB();
+    e32_rx_head = head;
+}
+
+static void e32_rx_end_packet(void)
+{
+    if (e32_rx_cur_len == 0) return;
+    uint8_t head = e32_pkt_head;
+    if ((uint8_t)(head - e32_pkt_tail) >= E32_RX_MAX_PACKETS) {
+        // Черга пакетів повна: байти приєднаються до наступного пакета
+        e32_rx_overruns++;
+        return;
+    }
+    e32_pkt_len[head & (E32_RX_MAX_PACKETS - 1)] = e32_rx_cur_len;
+    __DMB();
+    e32_pkt_head = (uint8_t)(head + 1);
+    e32_rx_cur_len = 0;
+}
+
+// Callback — викликається на паузі лінії та при заповненні LoRa_RX_Buffer.
+// Size — позиція запису в LoRa_RX_Buffer.
+void HAL_UARTEx_RxEventCallback(UART_HandleTypeDef *huart, uint16_t Size)
+{
+    if (huart->Instance != USART2) return;
+    PROF_BEGIN(PROF_E32_RX_EVENT);
+
+    if (Size > e32_rx_pos) {
+        e32_rx_push(&LoRa_RX_Buffer[e32_rx_pos], (uint16_t)(Size - e32_rx_pos));
+    }
+    e32_rx_pos = (Size >= E32_RX_DMA_SIZE) ? 0 : Size;
+
+    if (HAL_UARTEx_GetRxEventType(huart) == HAL_UART_RXEVENT_IDLE) {
+        e32_rx_end_packet();
+    }
+
+#if !E32_RX_USE_DMA
+    // Прийом по перериванню зупиняється після кожної події — перезапускаємо
+    E32_StartReceive();
+#endif
+    PROF_END(PROF_E32_RX_EVENT);
+}
+
+// Помилка UART. Передача: помилка DMA завершує її (gState знову READY).
+// Байти, які DMA вже віддав у UART (e32_tx_len мінус CNDTR), вийдуть у лінію —
+// їх звільняємо, а повторно йде лише решта частини, без дублів посеред кадру.
+// Прийом: після переповнення чи помилки DMA HAL зупиняє прийом (RxState
+// READY) — запускаємо знову; шум і помилку кадру в режимі переривань HAL
+// лише повідомляє, прийом триває.
+void HAL_UART_ErrorCallback(UART_HandleTypeDef *huart)
+{
+    if (huart->Instance != USART2) return;
+
+    if (e32_tx_len != 0 && huart->gState == HAL_UART_STATE_READY)
+    {
+        uint16_t left = (uint16_t)__HAL_DMA_GET_COUNTER(huart->hdmatx);
+        if (left > e32_tx_len) left = e32_tx_len;
+        e32_tx_tail = (uint16_t)(e32_tx_tail + e32_tx_len - left);
+        e32_tx_errors++;
+        e32_tx_len = 0;
+        e32_tx_kick();
+    }
+    if (huart->ErrorCode & (HAL_UART_ERROR_PE | HAL_UART_ERROR_NE | HAL_UART_ERROR_FE | HAL_UART_ERROR_ORE))
     {
+        e32_rx_overruns++;
+    }
+    if (huart->RxState == HAL_UART_STATE_READY) E32_StartReceive();
+}
 
-        uint8_t b = LoRa_RX_Buffer[0];
+// Забрати наступний завершений пакет: перші max байтів → buf (buf може бути
+// NULL). Повертає повну довжину пакета, 0 — пакетів немає.
+static uint16_t e32_rx_take(uint8_t *buf, uint16_t max)
+{
+    uint8_t pkt = e32_pkt_tail;
+    if (pkt == e32_pkt_head) return 0;
+    __DMB();
+
+    uint16_t len = e32_pkt_len[pkt & (E32_RX_MAX_PACKETS - 1)];
+    uint16_t tail = e32_rx_tail;
+    for (uint16_t i = 0; i < len; i++, tail++) {
+        if (buf != NULL && i < max) buf[i] = e32_rx_ring[tail & (E32_RX_RING_SIZE - 1)];
+    }
+
+    __DMB();
+    e32_rx_tail = tail;
+    e32_pkt_tail = (uint8_t)(pkt + 1);
+    return len;
+}
+
+// Наступний завершений пакет → buf (не більше max байтів, решта відкидається
+// і рахується в E32_RxTruncated). Пакет не довший за E32_RX_RING_SIZE.
+// Повертає кількість скопійованих байтів, 0 — пакетів немає.
+uint16_t E32_ReadPacket(uint8_t *buf, uint16_t max)
+{
+    if (buf == NULL) max = 0;
+    uint16_t len = e32_rx_take(buf, max);
+    if (len > max) {
+        e32_rx_truncated++;
+        len = max;
+    }
+    return len;
+}
+
+uint32_t E32_RxTruncated(void)
+{
+    return e32_rx_truncated;
+}
+
+uint32_t E32_RxOverruns(void)
+{
+    return e32_rx_overruns;
+}
 
-        if (b == '\n' || rx_idx >= RX_LINE_MAX-1)  // кінець рядка
+// Вивід звітів (#prof, #mem, #log, #bench) у відповідь через E32. Звіт
+// довший за чергу передачі, тому рядок чекає на місце (не довше
+// E32_CONFIG_TIMEOUT_MS)
+static void e32_report_out(const char *line)
+{
+    uint16_t n = (uint16_t)strlen(line);
+    uint32_t start = HAL_GetTick();
+    while ((uint16_t)(E32_TX_RING_SIZE - E32_TxPending()) < n &&
+           (HAL_GetTick() - start) < E32_CONFIG_TIMEOUT_MS) {
+    }
+    E32_SendString((char *)line);
+}
+
+// -------------------------
+// Двійкові кадри (frame.h)
+// -------------------------
+static frame_parser_t e32_frame_parser;
+static E32_FrameHandler e32_frame_handler = NULL;
+
+void E32_SetFrameHandler(E32_FrameHandler handler)
+{
+    e32_frame_handler = handler;
+}
+
+// Кадр іде в чергу передачі цілим або не йде зовсім
+HAL_StatusTypeDef E32_SendFrame(uint8_t type, const uint8_t *payload, uint8_t len)
+{
+    uint8_t buf[FRAME_MAX_SIZE];
+    size_t n = frame_encode(type, payload, len, buf, sizeof(buf));
+    if (n == 0) return HAL_ERROR;
+    if ((size_t)(E32_TX_RING_SIZE - E32_TxPending()) < n) return HAL_BUSY;
+    E32_Write(buf, (uint16_t)n);
+    return HAL_OK;
+}
+
+uint32_t E32_FrameErrors(void)
+{
+    return e32_frame_parser.crc_errors;
+}
+
+// Текстовий кадр — повідомлення журналу (частинами по розміру слота черги),
+// решта типів — обробнику застосунку
+static void e32_frame_dispatch(const frame_parser_t *p)
+{
+    if (p->type != FRAME_TYPE_TEXT)
+    {
+        if (e32_frame_handler != NULL) e32_frame_handler(p->type, p->payload, p->len);
+        return;
+    }
+
+    char text[DISPLAY_QUEUE_TEXT_MAX];
+    uint8_t pos = 0;
+    do {
+        uint8_t n = (uint8_t)(p->len - pos);
+        if (n > sizeof(text) - 1) n = sizeof(text) - 1;
+        memcpy(text, &p->payload[pos], n);
+        text[n] = 0;
+        display_queue_post_log(text);
+        pos = (uint8_t)(pos + n);
+    } while (pos < p->len);
+}
+
+// Обробка прийнятих пакетів у головному циклі. Пакет, що починається з
+// FRAME_SYNC, розбирається як двійкові кадри; кадр не виходить за межі
+// пакета, тож кожен пакет розбирається з нуля. Інакше це текст: рядок
+// збирається в rx_line через межі пакетів, доки не прийде '\n' або буфер
+// не заповниться, і тоді виводиться на дисплей.
+// Пакет "#mem" повертає використання стеку й купи (stackmon.h), "#log" —
+// журнал прийнятих повідомлень (msglog.h), з PROF_ENABLE пакет "#prof" —
+// таблицю профілювання, з SSD1306_USE_STATS пакет "#bench" запускає
+// ssd1306_bench_run() і повертає CSV.
+void E32_Poll(void)
+{
+    static uint8_t packet[E32_RX_RING_SIZE];  // найдовший можливий пакет
+    uint16_t len;
+
+    e32_tx_kick();  // передача, яку HAL не прийняв раніше
+
+    while ((len = E32_ReadPacket(packet, sizeof(packet))) > 0)
+    {
+#if PROF_ENABLE
+        // Пакет "#prof" — відправити таблицю профілювання у відповідь
+        if (len == 5 && memcmp(packet, "#prof", 5) == 0)
+        {
+            prof_dump(e32_report_out);
+            continue;
+        }
+#endif
+        // Пакет "#mem" — відправити використання пам'яті
+        if (len == 4 && memcmp(packet, "#mem", 4) == 0)
+        {
+            stackmon_report(e32_report_out);
+            continue;
+        }
+        // Пакет "#log" — відправити журнал прийнятих повідомлень
+        if (len == 4 && memcmp(packet, "#log", 4) == 0)
+        {
+            msglog_report(e32_report_out);
+            continue;
+        }
+#if SSD1306_USE_STATS
+        // Пакет "#bench" — бенчмарк дисплея; він малює поверх екрана,
+        // тому консоль ховається на час прогону й потім перемальовується
+        if (len == 6 && memcmp(packet, "#bench", 6) == 0)
         {
-            rx_line[rx_idx] = 0;  // завершити рядок
-            ssd1306_clear();      // очистити дисплей (або частково)
-            ssd1306_write_string(0, 0, rx_line);  // вивести прийняті дані
-            rx_idx = 0;           // скинути індекс
+            console_set_visible(0);
+            ssd1306_bench_run(e32_report_out);
+            console_set_visible(1);
+            continue;
         }
-        else
+#endif
+        if (packet[0] == FRAME_SYNC)
         {
-            rx_line[rx_idx++] = b;  // додати байт в буфер
+            frame_parser_packet(&e32_frame_parser, packet, len);
+            while (frame_parser_next(&e32_frame_parser)) e32_frame_dispatch(&e32_frame_parser);
+            continue;
         }
+        for (uint16_t i = 0; i < len; i++)
+        {
+            uint8_t b = packet[i];
 
-        HAL_UART_Receive_IT(&huart2, LoRa_RX_Buffer, 1);
+            if (b == '\n' || rx_idx >= RX_LINE_MAX-1)  // кінець рядка
+            {
+                if (rx_idx > 0)
+                {
+                    rx_line[rx_idx] = 0;  // завершити рядок
+                    display_queue_post_log(rx_line);  // новий рядок журналу
+                    rx_idx = 0;           // скинути індекс
+                }
+                if (b == '\n') continue;
+            }
+            if (b != '\r') rx_line[rx_idx++] = b;  // додати байт в буфер
+        }
     }
 }
 
 // -------------------------
-// OLED custom functions
+// Конфігурація модуля
 // -------------------------
-void oled_print_char(char c)
-{
-    static uint8_t x = 0;
-    static uint8_t y = 0;
-
-    // якщо дійшли до кінця рядка
-    if (x > 120) {
-        x = 0;
-        y += 8;
-        if (y > 56) {    // дисплей 128x64 → 8 рядків
-            y = 0;
-            ssd1306_clear();
-        }
+#define E32_CMD_SAVE       0xC0  // записати параметри у флеш
+#define E32_CMD_READ       0xC1  // C1 C1 C1 → C0 + 5 байтів параметрів
+#define E32_CMD_TEMPORARY  0xC2  // записати до вимкнення живлення
+#define E32_PROGRAM_BAUD   9600  // у режимі програмування UART завжди 9600 8N1
+
+static const uint32_t e32_baud_table[8] = {
+    1200, 2400, 4800, 9600, 19200, 38400, 57600, 115200
+};
+
+void E32_ConfigDecode(const uint8_t raw[E32_CONFIG_SIZE], E32_Config *cfg)
+{
+    uint8_t sped = raw[3];
+    uint8_t air = sped & 0x07;
+    uint8_t option = raw[5];
+
+    cfg->addh = raw[1];
+    cfg->addl = raw[2];
+    cfg->parity = (E32_Parity)((sped >> 6) == 3 ? 0 : (sped >> 6));  // 11 = 8N1
+    cfg->uart_baud = e32_baud_table[(sped >> 3) & 0x07];
+    cfg->air_rate = (E32_AirRate)(air > E32_AIR_19200 ? E32_AIR_19200 : air);  // 110, 111 = 19.2k
+    cfg->channel = raw[4] & 0x1F;
+    cfg->fixed_tx = (option >> 7) & 1;
+    cfg->io_push_pull = (option >> 6) & 1;
+    cfg->wakeup = (option >> 3) & 0x07;
+    cfg->fec = (option >> 2) & 1;
+    cfg->power = option & 0x03;
+}
+
+HAL_StatusTypeDef E32_ConfigEncode(const E32_Config *cfg, uint8_t save, uint8_t raw[E32_CONFIG_SIZE])
+{
+    uint8_t baud = 0;
+    while (baud < 8 && e32_baud_table[baud] != cfg->uart_baud) baud++;
+    if (baud == 8 || cfg->parity > E32_PARITY_8E1 || cfg->air_rate > E32_AIR_19200 ||
+        cfg->channel > 0x1F || cfg->wakeup > 7 || cfg->power > 3) return HAL_ERROR;
+
+    raw[0] = save ? E32_CMD_SAVE : E32_CMD_TEMPORARY;
+    raw[1] = cfg->addh;
+    raw[2] = cfg->addl;
+    raw[3] = (uint8_t)((cfg->parity << 6) | (baud << 3) | cfg->air_rate);
+    raw[4] = cfg->channel;
+    raw[5] = (uint8_t)(((cfg->fixed_tx & 1) << 7) | ((cfg->io_push_pull & 1) << 6) |
+                       (cfg->wakeup << 3) | ((cfg->fec & 1) << 2) | cfg->power);
+    return HAL_OK;
+}
+
+// Парність модуля → значення UART_PARITY_* (це й біти PCE/PS у CR1)
+static uint32_t e32_uart_parity(E32_Parity parity)
+{
+    if (parity == E32_PARITY_8O1) return UART_PARITY_ODD;
+    if (parity == E32_PARITY_8E1) return UART_PARITY_EVEN;
+    return UART_PARITY_NONE;
+}
+
+// Змінити лише дільник і формат кадру USART2 (викликається між передачами):
+// прийом і DMA продовжують працювати. З парністю кадр має 9 біт (M = 1):
+// 8 біт даних + біт парності, як у модуля.
+static void e32_uart_format(uint32_t baud, uint32_t parity)
+{
+    uint32_t word = (parity == UART_PARITY_NONE) ? UART_WORDLENGTH_8B : UART_WORDLENGTH_9B;
+
+    if (LORA_UART->Init.BaudRate == baud && LORA_UART->Init.Parity == parity &&
+        LORA_UART->Init.WordLength == word) return;
+    LORA_UART->Init.BaudRate = baud;
+    LORA_UART->Init.Parity = parity;
+    LORA_UART->Init.WordLength = word;
+    LORA_UART->Instance->BRR = UART_BRR_SAMPLING16(HAL_RCC_GetPCLK1Freq(), baud);
+    LORA_UART->Instance->CR1 = (LORA_UART->Instance->CR1 & ~(USART_CR1_M | USART_CR1_PCE | USART_CR1_PS)) |
+                               word | parity;
+}
+
+// Дочекатися, поки черга передачі спорожніє і останній байт вийде з UART
+static HAL_StatusTypeDef e32_wait_tx(uint32_t timeout)
+{
+    uint32_t start = HAL_GetTick();
+    while (E32_TxPending() > 0 || !__HAL_UART_GET_FLAG(LORA_UART, UART_FLAG_TC))
+    {
+        if ((HAL_GetTick() - start) > timeout) return HAL_TIMEOUT;
+    }
+    return HAL_OK;
+}
+
+// Надіслати команду і дочекатися відповіді (пакет, закінчений паузою).
+// Повертає повну довжину відповіді (у resp — не більше max байтів),
+// 0 — немає відповіді.
+static uint16_t e32_transact(const uint8_t *cmd, uint16_t len, uint8_t *resp, uint16_t max)
+{
+    while (e32_rx_take(NULL, 0) > 0) {}  // старі пакети вже не потрібні
+
+    E32_Write(cmd, len);
+    if (e32_wait_tx(E32_CONFIG_TIMEOUT_MS) != HAL_OK) return 0;
+
+    uint32_t start = HAL_GetTick();
+    uint16_t n;
+    while ((n = e32_rx_take(resp, max)) == 0)
+    {
+        if ((HAL_GetTick() - start) > E32_CONFIG_TIMEOUT_MS) return 0;
+    }
+    return n;
+}
+
+static HAL_StatusTypeDef e32_read_raw(uint8_t raw[E32_CONFIG_SIZE])
+{
+    static const uint8_t cmd[3] = { E32_CMD_READ, E32_CMD_READ, E32_CMD_READ };
+    uint16_t n = e32_transact(cmd, sizeof(cmd), raw, E32_CONFIG_SIZE);
+    return (n == E32_CONFIG_SIZE && raw[0] == E32_CMD_SAVE) ? HAL_OK : HAL_ERROR;
+}
+
+// Вхід у режим програмування; повертає режим, у який треба повернутися
+static HAL_StatusTypeDef e32_enter_program(E32_Mode *prev)
+{
+    *prev = e32_mode;
+    if (e32_wait_tx(E32_CONFIG_TIMEOUT_MS) != HAL_OK) return HAL_TIMEOUT;
+    E32_SetMode(E32_MODE_PROGRAM);
+    e32_uart_format(E32_PROGRAM_BAUD, UART_PARITY_NONE);
+    return e32_wait_aux(E32_CONFIG_TIMEOUT_MS);
+}
+
+static void e32_leave_program(E32_Mode prev, uint32_t baud, uint32_t parity)
+{
+    e32_wait_aux(E32_CONFIG_TIMEOUT_MS);
+    E32_SetMode(prev);
+    if (prev != E32_MODE_PROGRAM) e32_uart_format(baud, parity);
+}
+
+HAL_StatusTypeDef E32_ReadConfig(E32_Config *cfg)
+{
+    E32_Mode prev;
+    uint8_t raw[E32_CONFIG_SIZE];
+    uint32_t baud = LORA_UART->Init.BaudRate;
+    uint32_t parity = LORA_UART->Init.Parity;
+
+    if (cfg == NULL) return HAL_ERROR;
+    HAL_StatusTypeDef st = e32_enter_program(&prev);
+    if (st == HAL_OK) st = e32_read_raw(raw);
+    if (st == HAL_OK)
+    {
+        E32_ConfigDecode(raw, cfg);
+        baud = cfg->uart_baud;
+        parity = e32_uart_parity(cfg->parity);
     }
+    e32_leave_program(prev, baud, parity);
+    return st;
+}
+
+HAL_StatusTypeDef E32_WriteConfig(const E32_Config *cfg, uint8_t save)
+{
+    E32_Mode prev;
+    uint8_t raw[E32_CONFIG_SIZE];
+    uint8_t check[E32_CONFIG_SIZE];
+    uint32_t baud = LORA_UART->Init.BaudRate;
+    uint32_t parity = LORA_UART->Init.Parity;
 
-    char buf[2] = { c, 0 };
-    ssd1306_write_string(x, y, buf); // Вивести символ
-    x += 6; // ширина символа 5x8 + 1
+    if (cfg == NULL || E32_ConfigEncode(cfg, save, raw) != HAL_OK) return HAL_ERROR;
+
+    HAL_StatusTypeDef st = e32_enter_program(&prev);
+    if (st == HAL_OK)
+    {
+        // Модуль відповідає на запис тим самим блоком, іноді вже після
+        // підйому AUX. Відповідь забираємо тут, інакше її візьмуть за
+        // відповідь на перевірочне читання. Результат перевіряється читанням.
+        uint8_t echo[E32_CONFIG_SIZE];
+        e32_transact(raw, sizeof(raw), echo, sizeof(echo));
+        st = e32_wait_aux(E32_CONFIG_TIMEOUT_MS);
+    }
+    if (st == HAL_OK) st = e32_read_raw(check);
+    if (st == HAL_OK)
+    {
+        E32_Config applied;
+        E32_ConfigDecode(check, &applied);
+        baud = applied.uart_baud;  // UART працюватиме з тим, що реально записано
+        parity = e32_uart_parity(applied.parity);
+        if (memcmp(&raw[1], &check[1], E32_CONFIG_SIZE - 1) != 0) st = HAL_ERROR;
+    }
+    e32_leave_program(prev, baud, parity);
+    return st;
 }
@@ -0,0 +1,122 @@
+#include "fixfmt.h"
+
+static const uint32_t fixfmt_pow10[10] = {
+    1u, 10u, 100u, 1000u, 10000u, 100000u, 1000000u, 10000000u, 100000000u, 1000000000u
+};
+
+/* Output cursor: characters are dropped once the buffer is full and the
+   result is then reported as not fitting */
+typedef struct {
+    char *out;
+    size_t len;
+    size_t n;
+} fixfmt_buf_t;
+
+static void fixfmt_putc(fixfmt_buf_t *b, char c)
+{
+    if (b->n + 1 < b->len) b->out[b->n] = c;
+    b->n++;
+}
+
+/* v in decimal, zero-padded to at least `width` digits */
+static void fixfmt_putu(fixfmt_buf_t *b, uint32_t v, uint8_t width)
+{
+    char tmp[10];
+    uint8_t n = 0;
+    do {
+        tmp[n++] = (char)('0' + v % 10);
+        v /= 10;
+    } while (v != 0);
+    while (n < width && n < sizeof(tmp)) tmp[n++] = '0';
+    while (n > 0) fixfmt_putc(b, tmp[--n]);
+}
+
+static size_t fixfmt_end(fixfmt_buf_t *b)
+{
+    if (b->len == 0) return 0;
+    if (b->n + 1 > b->len) {
+        b->out[0] = '\0';
+        return 0;
+    }
+    b->out[b->n] = '\0';
+    return b->n;
+}
+
+static uint32_t fixfmt_abs(int32_t v)
+{
+    return (v < 0) ? (uint32_t)0 - (uint32_t)v : (uint32_t)v;
+}
+
+size_t fixfmt_u32(char *out, size_t len, uint32_t v)
+{
+    fixfmt_buf_t b = { out, len, 0 };
+    if (out == NULL) return 0;
+    fixfmt_putu(&b, v, 1);
+    return fixfmt_end(&b);
+}
+
+size_t fixfmt_i32(char *out, size_t len, int32_t v)
+{
+    fixfmt_buf_t b = { out, len, 0 };
+    if (out == NULL) return 0;
+    if (v < 0) fixfmt_putc(&b, '-');
+    fixfmt_putu(&b, fixfmt_abs(v), 1);
+    return fixfmt_end(&b);
+}
+
+/* Sign and mag / 10^decimals; mag is unsigned so that -2^31 needs no
+   negation in int32 */
+static size_t fixfmt_sign_mag(char *out, size_t len, uint8_t neg, uint32_t mag, uint8_t decimals)
+{
+    fixfmt_buf_t b = { out, len, 0 };
+    if (out == NULL) return 0;
+    if (decimals > 9) decimals = 9;
+
+    uint32_t scale = fixfmt_pow10[decimals];
+
+    if (neg) fixfmt_putc(&b, '-');
+    fixfmt_putu(&b, mag / scale, 1);
+    if (decimals > 0) {
+        fixfmt_putc(&b, '.');
+        fixfmt_putu(&b, mag % scale, decimals);
+    }
+    return fixfmt_end(&b);
+}
+
+size_t fixfmt_fixed(char *out, size_t len, int32_t value, uint8_t decimals)
+{
+    return fixfmt_sign_mag(out, len, value < 0, fixfmt_abs(value), decimals);
+}
+
+size_t fixfmt_deg(char *out, size_t len, int32_t deg_e7, uint8_t decimals)
+{
+    if (decimals > 7) decimals = 7;
+    uint32_t div = fixfmt_pow10[7 - decimals];
+    uint32_t mag = (fixfmt_abs(deg_e7) + div / 2) / div; /* round half away from zero */
+    return fixfmt_sign_mag(out, len, deg_e7 < 0 && mag != 0, mag, decimals);
+}
+
+size_t fixfmt_dm(char *out, size_t len, int32_t deg_e7, char pos, char neg)
+{
+    fixfmt_buf_t b = { out, len, 0 };
+    if (out == NULL) return 0;
+
+    uint32_t mag = fixfmt_abs(deg_e7);
+    uint32_t deg = mag / 10000000u;
+    /* Fraction of a degree in thousandths of a minute: rem * 60000 / 1e7 */
+    uint32_t mmin = ((mag % 10000000u) * 3u + 250u) / 500u;
+    if (mmin >= 60000u) {
+        deg++;
+        mmin -= 60000u;
+    }
+
+    fixfmt_putu(&b, deg, 2);
+    fixfmt_putc(&b, FIXFMT_DEGREE);
+    fixfmt_putu(&b, mmin / 1000u, 2);
+    fixfmt_putc(&b, '.');
+    fixfmt_putu(&b, mmin % 1000u, 3);
+    fixfmt_putc(&b, '\'');
+    fixfmt_putc(&b, ' ');
+    fixfmt_putc(&b, (deg_e7 < 0) ? neg : pos);
+    return fixfmt_end(&b);
+}
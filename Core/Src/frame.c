@@ -0,0 +1,71 @@
+#include "frame.h"
+
+/* CRC-16/CCITT one nibble at a time: 32 bytes of table instead of 512 */
+static const uint16_t frame_crc_nibble[16] = {
+    0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+    0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF
+};
+
+static uint16_t frame_crc_byte(uint16_t crc, uint8_t b)
+{
+    crc = (uint16_t)((crc << 4) ^ frame_crc_nibble[(crc >> 12) ^ (b >> 4)]);
+    crc = (uint16_t)((crc << 4) ^ frame_crc_nibble[(crc >> 12) ^ (b & 0x0F)]);
+    return crc;
+}
+
+uint16_t frame_crc16(uint16_t crc, const uint8_t *data, size_t len)
+{
+    for (size_t i = 0; i < len; i++) crc = frame_crc_byte(crc, data[i]);
+    return crc;
+}
+
+size_t frame_encode(uint8_t type, const uint8_t *payload, uint8_t len, uint8_t *out, size_t out_size)
+{
+    size_t size = (size_t)len + FRAME_OVERHEAD;
+    if (out == NULL || len > FRAME_MAX_PAYLOAD || out_size < size || (len > 0 && payload == NULL)) return 0;
+
+    out[0] = FRAME_SYNC;
+    out[1] = len;
+    out[2] = type;
+    for (uint8_t i = 0; i < len; i++) out[3 + i] = payload[i];
+
+    uint16_t crc = frame_crc16(0xFFFF, &out[1], (size_t)len + 2);
+    out[3 + len] = (uint8_t)crc;
+    out[4 + len] = (uint8_t)(crc >> 8);
+    return size;
+}
+
+void frame_parser_packet(frame_parser_t *p, const uint8_t *data, size_t size)
+{
+    p->data = data;
+    p->size = (data != NULL) ? size : 0;
+    p->pos = 0;
+}
+
+uint8_t frame_parser_next(frame_parser_t *p)
+{
+    while (p->pos < p->size) {
+        const uint8_t *f = &p->data[p->pos++];
+        if (f[0] != FRAME_SYNC) continue;
+
+        /* From here on a failed check only drops this SYNC byte */
+        size_t left = p->size - p->pos + 1;
+        if (left < FRAME_OVERHEAD || f[1] > FRAME_MAX_PAYLOAD || left < (size_t)f[1] + FRAME_OVERHEAD) {
+            p->crc_errors++;
+            continue;
+        }
+        uint8_t len = f[1];
+        uint16_t crc = frame_crc16(0xFFFF, &f[1], (size_t)len + 2);
+        if (crc != (uint16_t)(f[3 + len] | (f[4 + len] << 8))) {
+            p->crc_errors++;
+            continue;
+        }
+
+        p->len = len;
+        p->type = f[2];
+        p->payload = &f[3];
+        p->pos += (size_t)len + FRAME_OVERHEAD - 1;
+        return 1;
+    }
+    return 0;
+}
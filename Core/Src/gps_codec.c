@@ -0,0 +1,137 @@
+#include "gps_codec.h"
+
+#define GPS_CODEC_DELTA 0x80
+#define GPS_CODEC_SEQ   0x7F
+
+/* Deltas are computed modulo 2^32, so a jump across the +/-180 meridian
+   still round-trips exactly */
+static uint32_t gps_zigzag(uint32_t d)
+{
+    return (d << 1) ^ (0u - (d >> 31));
+}
+
+static uint32_t gps_unzigzag(uint32_t z)
+{
+    return (z >> 1) ^ (0u - (z & 1u));
+}
+
+static size_t gps_put_varint(uint8_t *out, uint32_t v)
+{
+    size_t n = 0;
+    while (v >= 0x80) {
+        out[n++] = (uint8_t)(v | 0x80);
+        v >>= 7;
+    }
+    out[n++] = (uint8_t)v;
+    return n;
+}
+
+/* Returns the bytes consumed, 0 if the varint is truncated or too long */
+static size_t gps_get_varint(const uint8_t *in, size_t len, uint32_t *v)
+{
+    uint32_t r = 0;
+    for (size_t i = 0; i < len && i < 5; i++) {
+        r |= (uint32_t)(in[i] & 0x7F) << (7 * i);
+        if ((in[i] & 0x80) == 0) {
+            *v = r;
+            return i + 1;
+        }
+    }
+    return 0;
+}
+
+static void gps_put_le(uint8_t *out, uint32_t v, uint8_t bytes)
+{
+    for (uint8_t i = 0; i < bytes; i++) out[i] = (uint8_t)(v >> (8 * i));
+}
+
+static uint32_t gps_get_le(const uint8_t *in, uint8_t bytes)
+{
+    uint32_t v = 0;
+    for (uint8_t i = 0; i < bytes; i++) v |= (uint32_t)in[i] << (8 * i);
+    return v;
+}
+
+void gps_codec_init(gps_codec_t *c)
+{
+    c->ref.lat_e7 = 0;
+    c->ref.lon_e7 = 0;
+    c->ref.alt_dm = 0;
+    c->seq = GPS_CODEC_SEQ;
+    c->valid = 0;
+    c->since_key = 0;
+}
+
+size_t gps_encode(gps_codec_t *c, const gps_fix_t *fix, uint8_t *out, size_t out_size)
+{
+    if (c == NULL || fix == NULL || out == NULL || out_size < GPS_CODEC_MAX_SIZE) return 0;
+
+    uint8_t seq = (uint8_t)((c->seq + 1) & GPS_CODEC_SEQ);
+    size_t n = 0;
+
+    if (c->valid && c->since_key < GPS_CODEC_KEY_INTERVAL - 1) {
+        /* Worst case 1 + 5 + 5 + 3 bytes: build in a scratch buffer */
+        uint8_t delta[14];
+        size_t k = 1;
+        k += gps_put_varint(&delta[k], gps_zigzag((uint32_t)fix->lat_e7 - (uint32_t)c->ref.lat_e7));
+        k += gps_put_varint(&delta[k], gps_zigzag((uint32_t)fix->lon_e7 - (uint32_t)c->ref.lon_e7));
+        k += gps_put_varint(&delta[k], gps_zigzag((uint32_t)(int32_t)fix->alt_dm - (uint32_t)(int32_t)c->ref.alt_dm));
+        if (k < GPS_CODEC_KEY_SIZE) {
+            delta[0] = (uint8_t)(GPS_CODEC_DELTA | seq);
+            for (size_t i = 0; i < k; i++) out[i] = delta[i];
+            n = k;
+            c->since_key++;
+        }
+    }
+
+    if (n == 0) {
+        out[0] = seq;
+        gps_put_le(&out[1], (uint32_t)fix->lat_e7, 4);
+        gps_put_le(&out[5], (uint32_t)fix->lon_e7, 4);
+        gps_put_le(&out[9], (uint16_t)fix->alt_dm, 2);
+        n = GPS_CODEC_KEY_SIZE;
+        c->since_key = 0;
+    }
+
+    c->ref = *fix;
+    c->seq = seq;
+    c->valid = 1;
+    return n;
+}
+
+uint8_t gps_decode(gps_codec_t *c, const uint8_t *in, size_t len, gps_fix_t *fix)
+{
+    if (c == NULL || in == NULL || fix == NULL || len == 0) return 0;
+
+    uint8_t seq = in[0] & GPS_CODEC_SEQ;
+    gps_fix_t f;
+
+    if ((in[0] & GPS_CODEC_DELTA) == 0) {
+        if (len != GPS_CODEC_KEY_SIZE) return 0;
+        f.lat_e7 = (int32_t)gps_get_le(&in[1], 4);
+        f.lon_e7 = (int32_t)gps_get_le(&in[5], 4);
+        f.alt_dm = (int16_t)gps_get_le(&in[9], 2);
+    } else {
+        if (!c->valid || seq != ((c->seq + 1) & GPS_CODEC_SEQ)) {
+            c->valid = 0; /* chain broken: wait for a key report */
+            return 0;
+        }
+        uint32_t d[3];
+        size_t pos = 1;
+        for (uint8_t i = 0; i < 3; i++) {
+            size_t k = gps_get_varint(&in[pos], len - pos, &d[i]);
+            if (k == 0) return 0;
+            pos += k;
+        }
+        if (pos != len) return 0;
+        f.lat_e7 = (int32_t)((uint32_t)c->ref.lat_e7 + gps_unzigzag(d[0]));
+        f.lon_e7 = (int32_t)((uint32_t)c->ref.lon_e7 + gps_unzigzag(d[1]));
+        f.alt_dm = (int16_t)(uint16_t)((uint32_t)(int32_t)c->ref.alt_dm + gps_unzigzag(d[2]));
+    }
+
+    c->ref = f;
+    c->seq = seq;
+    c->valid = 1;
+    *fix = f;
+    return 1;
+}
@@ -23,6 +23,13 @@
 /* USER CODE BEGIN Includes */
 #include "ssd1306.h"
 #include "e32.h"
+#include "display_queue.h"
+#include "console.h"
+#include "frame.h"
+#include "gps_codec.h"
+#include "prof.h"
+#include "stackmon.h"
+#include "clock.h"
 /* USER CODE END Includes */
 
 /* Private typedef -----------------------------------------------------------*/
@@ -32,6 +39,8 @@
 
 /* Private define ------------------------------------------------------------*/
 /* USER CODE BEGIN PD */
+// Без нових фіксів протягом цього часу екран повертається до консолі
+#define GPS_VIEW_TIMEOUT_MS 5000
 
 /* USER CODE END PD */
 
@@ -42,16 +51,24 @@
 
 /* Private variables ---------------------------------------------------------*/
 I2C_HandleTypeDef hi2c1;
+DMA_HandleTypeDef hdma_i2c1_tx;
 
 UART_HandleTypeDef huart2;
+DMA_HandleTypeDef hdma_usart2_tx;
 
 /* USER CODE BEGIN PV */
-
+#if E32_RX_USE_DMA
+DMA_HandleTypeDef hdma_usart2_rx;
+#endif
+static gps_codec_t gps_rx;
+static uint32_t gps_last_fix;
+static uint8_t gps_view;
 /* USER CODE END PV */
 
 /* Private function prototypes -----------------------------------------------*/
 void SystemClock_Config(void);
 static void MX_GPIO_Init(void);
+static void MX_DMA_Init(void);
 static void MX_I2C1_Init(void);
 static void MX_USART2_UART_Init(void);
 /* USER CODE BEGIN PFP */
@@ -60,6 +77,23 @@ static void MX_USART2_UART_Init(void);
 
 /* Private user code ---------------------------------------------------------*/
 /* USER CODE BEGIN 0 */
+// Кадри FRAME_TYPE_GPS: звіт декодується відносно попереднього фіксу
+// і показується видом координат замість консолі
+static void e32_frame_received(uint8_t type, const uint8_t *payload, uint8_t len)
+{
+  gps_fix_t fix;
+  if (type != FRAME_TYPE_GPS || !gps_decode(&gps_rx, payload, len, &fix)) return;
+
+  if (!gps_view)
+  {
+    console_set_visible(0);
+    ssd1306_clear();
+    Display_ResetCoordinates();
+    gps_view = 1;
+  }
+  Display_ShowCoordinatesE7(fix.lat_e7, fix.lon_e7, fix.alt_dm);
+  gps_last_fix = HAL_GetTick();
+}
 
 /* USER CODE END 0 */
 
@@ -71,7 +105,8 @@ int main(void)
 {
 
   /* USER CODE BEGIN 1 */
-
+  // Заповнюємо вільну RAM шаблоном: глибину стеку покаже пакет "#mem"
+  stackmon_paint();
   /* USER CODE END 1 */
 
   /* MCU Configuration--------------------------------------------------------*/
@@ -87,21 +122,47 @@ int main(void)
   SystemClock_Config();
 
   /* USER CODE BEGIN SysInit */
-
+  // Робоча частота 72 МГц від кварцу; без кварцу — 64 МГц від HSI через PLL
+  if (clock_set_profile(CLOCK_PROFILE_HSE_72MHZ) != HAL_OK)
+  {
+    clock_set_profile(CLOCK_PROFILE_HSI_64MHZ);
+  }
   /* USER CODE END SysInit */
 
   /* Initialize all configured peripherals */
   MX_GPIO_Init();
+  MX_DMA_Init();
   MX_I2C1_Init();
   MX_USART2_UART_Init();
   /* USER CODE BEGIN 2 */
+  // Лічильник тактів DWT для профілювання (нічого не робить без PROF_ENABLE)
+  PROF_INIT();
+  // Спершу дисплей: налаштування E32 без модуля чекає секунди
+  ssd1306_init();
+  // Консоль на весь екран: прийняті рядки прокручуються апаратно
+  console_clear();
+  console_puts("Hello 5x8!e\n");
+  ssd1306_flush();
   // Запускаємо переривання UART
   E32_SetMode(E32_MODE_NORMAL);
-  HAL_UART_Receive_IT(LORA_UART, LoRa_RX_Buffer, 1);
-  ssd1306_init();
-  ssd1306_clear();
-  // Вивід рядка шрифтом 5x8 на першій сторінці
-  ssd1306_write_string(0, 0, "Hello 5x8!e");
+  E32_StartReceive();
+  // Параметри модуля: UART E32_UART_BAUD і швидкість в ефірі E32_AIR_RATE.
+  // У флеш модуля пишемо лише якщо вони відрізняються; USART2 після цього
+  // працює на швидкості, записаній у модулі.
+  E32_Config e32_cfg;
+  if (E32_ReadConfig(&e32_cfg) != HAL_OK)
+  {
+    console_puts("E32: no reply\n");
+  }
+  else if (e32_cfg.uart_baud != E32_UART_BAUD || e32_cfg.air_rate != E32_AIR_RATE)
+  {
+    e32_cfg.uart_baud = E32_UART_BAUD;
+    e32_cfg.air_rate = E32_AIR_RATE;
+    E32_WriteConfig(&e32_cfg, 1);
+  }
+  gps_codec_init(&gps_rx);
+  E32_SetFrameHandler(e32_frame_received);
+  ssd1306_flush();
   /* USER CODE END 2 */
 
   /* Infinite loop */
@@ -111,6 +172,17 @@ int main(void)
     /* USER CODE END WHILE */
 
     /* USER CODE BEGIN 3 */
+    // Прийняті пакети E32 → рядки на дисплей
+    E32_Poll();
+    if (gps_view && HAL_GetTick() - gps_last_fix > GPS_VIEW_TIMEOUT_MS)
+    {
+      gps_view = 0;
+      console_set_visible(1);
+    }
+    // Виконуємо запити на малювання, поставлені E32_Poll з прийнятих пакетів
+    display_queue_drain();
+    // Змінені сторінки кадрового буфера передаються у фоні через DMA
+    ssd1306_flush_async();
   }
   /* USER CODE END 3 */
 }
@@ -218,6 +290,25 @@ static void MX_USART2_UART_Init(void)
 
 }
 
+/**
+  * Enable DMA controller clock
+  */
+static void MX_DMA_Init(void)
+{
+
+  /* DMA controller clock enable */
+  __HAL_RCC_DMA1_CLK_ENABLE();
+
+  /* DMA interrupt init */
+  /* DMA1_Channel6_IRQn interrupt configuration */
+  HAL_NVIC_SetPriority(DMA1_Channel6_IRQn, 0, 0);
+  HAL_NVIC_EnableIRQ(DMA1_Channel6_IRQn);
+  /* DMA1_Channel7_IRQn interrupt configuration */
+  HAL_NVIC_SetPriority(DMA1_Channel7_IRQn, 0, 0);
+  HAL_NVIC_EnableIRQ(DMA1_Channel7_IRQn);
+
+}
+
 /**
   * @brief GPIO Initialization Function
   * @param None
@@ -244,6 +335,16 @@ static void MX_GPIO_Init(void)
   GPIO_InitStruct.Speed = GPIO_SPEED_FREQ_LOW;
   HAL_GPIO_Init(GPIOB, &GPIO_InitStruct);
 
+  /*Configure GPIO pin : PB14 */
+  GPIO_InitStruct.Pin = GPIO_PIN_14;
+  GPIO_InitStruct.Mode = GPIO_MODE_IT_RISING;
+  GPIO_InitStruct.Pull = GPIO_NOPULL;
+  HAL_GPIO_Init(GPIOB, &GPIO_InitStruct);
+
+  /* EXTI interrupt init*/
+  HAL_NVIC_SetPriority(EXTI15_10_IRQn, 0, 0);
+  HAL_NVIC_EnableIRQ(EXTI15_10_IRQn);
+
   /* USER CODE BEGIN MX_GPIO_Init_2 */
 
   /* USER CODE END MX_GPIO_Init_2 */
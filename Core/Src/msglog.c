@@ -0,0 +1,74 @@
+#include "msglog.h"
+#include "console.h"
+#include <string.h>
+
+static msglog_entry_t msglog_ring[MSGLOG_DEPTH];
+static uint16_t msglog_head;  /* slot of the next message */
+static uint16_t msglog_used;
+
+/* "MM:SS " of the uptime, minutes wrap at 100 */
+static void msglog_stamp(char *out, uint32_t tick)
+{
+    uint32_t s = tick / 1000u;
+    uint8_t m = (uint8_t)((s / 60u) % 100u);
+    uint8_t sec = (uint8_t)(s % 60u);
+
+    out[0] = (char)('0' + m / 10);
+    out[1] = (char)('0' + m % 10);
+    out[2] = ':';
+    out[3] = (char)('0' + sec / 10);
+    out[4] = (char)('0' + sec % 10);
+    out[5] = ' ';
+    out[6] = '\0';
+}
+
+static void msglog_show(const msglog_entry_t *e)
+{
+    char stamp[7];
+
+    msglog_stamp(stamp, e->tick);
+    console_puts(stamp);
+    console_puts(e->text);
+    console_putc('\n');
+}
+
+void msglog_add(const char *text)
+{
+    msglog_entry_t *e = &msglog_ring[msglog_head];
+
+    e->tick = HAL_GetTick();
+    strncpy(e->text, (text != NULL) ? text : "", sizeof(e->text) - 1);
+    e->text[sizeof(e->text) - 1] = '\0';
+
+    msglog_head = (uint16_t)((msglog_head + 1) % MSGLOG_DEPTH);
+    if (msglog_used < MSGLOG_DEPTH) msglog_used++;
+
+    msglog_show(e);
+}
+
+uint16_t msglog_count(void)
+{
+    return msglog_used;
+}
+
+const msglog_entry_t *msglog_get(uint16_t age)
+{
+    if (age >= msglog_used) return NULL;
+    return &msglog_ring[(msglog_head + MSGLOG_DEPTH - 1u - age) % MSGLOG_DEPTH];
+}
+
+void msglog_report(void (*out)(const char *line))
+{
+    char line[6 + MSGLOG_TEXT_MAX + 1];
+
+    for (uint16_t age = msglog_used; age-- > 0;) {
+        const msglog_entry_t *e = msglog_get(age);
+        size_t n = strlen(e->text);
+
+        msglog_stamp(line, e->tick);
+        memcpy(&line[6], e->text, n);
+        line[6 + n] = '\n';
+        line[7 + n] = '\0';
+        out(line);
+    }
+}
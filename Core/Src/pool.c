@@ -0,0 +1,94 @@
+#include "pool.h"
+#include "stm32f1xx_hal.h"
+
+void pool_init(pool_t *pool, void *storage, size_t block_size, uint16_t count)
+{
+    pool->storage = storage;
+    pool->block_size = (uint16_t)(POOL_BLOCK_WORDS(block_size) * 4u);
+    pool->count = count;
+    pool->used = 0;
+    pool->peak = 0;
+    pool->failures = 0;
+    pool->bad_frees = 0;
+
+    /* Thread the free list through the blocks, first block on top */
+    pool->free_list = NULL;
+    for (uint16_t i = count; i > 0; i--) {
+        void **block = (void **)(pool->storage + (size_t)(i - 1u) * pool->block_size);
+        *block = pool->free_list;
+        pool->free_list = block;
+    }
+}
+
+void *pool_alloc(pool_t *pool)
+{
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+
+    void **block = pool->free_list;
+    if (block != NULL) {
+        pool->free_list = *block;
+        pool->used++;
+        if (pool->used > pool->peak) pool->peak = pool->used;
+    } else {
+        pool->failures++;
+    }
+
+    __set_PRIMASK(primask);
+    return block;
+}
+
+#if POOL_CHECK_FREE
+static uint8_t pool_is_free(const pool_t *pool, const void *block)
+{
+    for (void *const *blk = pool->free_list; blk != NULL; blk = *blk) {
+        if (blk == block) return 1;
+    }
+    return 0;
+}
+#endif
+
+void pool_free(pool_t *pool, void *block)
+{
+    if (block == NULL) return;
+
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+
+    size_t offset = (size_t)((uint8_t *)block - pool->storage);
+    uint8_t bad = (uint8_t *)block < pool->storage || offset >= (size_t)pool->count * pool->block_size ||
+                  offset % pool->block_size != 0 || pool->used == 0;
+#if POOL_CHECK_FREE
+    if (!bad) bad = pool_is_free(pool, block);
+#endif
+
+    if (bad) {
+        pool->bad_frees++;
+    } else {
+        *(void **)block = pool->free_list;
+        pool->free_list = block;
+        pool->used--;
+    }
+
+    __set_PRIMASK(primask);
+}
+
+uint16_t pool_used(const pool_t *pool)
+{
+    return pool->used;
+}
+
+uint16_t pool_peak(const pool_t *pool)
+{
+    return pool->peak;
+}
+
+uint32_t pool_failures(const pool_t *pool)
+{
+    return pool->failures;
+}
+
+uint32_t pool_bad_frees(const pool_t *pool)
+{
+    return pool->bad_frees;
+}
@@ -0,0 +1,113 @@
+#include "prof.h"
+
+#if PROF_ENABLE
+
+#if defined(__arm__)
+#include "stm32f1xx.h"
+#else
+#include <time.h>
+#endif
+
+typedef struct {
+    uint32_t count;
+    uint32_t min;
+    uint32_t max;
+    uint64_t total;
+} prof_entry_t;
+
+static prof_entry_t prof_table[PROF_COUNT];
+
+static const char *const prof_names[PROF_COUNT] = {
+    [PROF_SSD1306_DATA]   = "ssd1306_data",
+    [PROF_SSD1306_WINDOW] = "ssd1306_set_window",
+    [PROF_SSD1306_GLYPH]  = "ssd1306_glyph",
+    [PROF_SSD1306_FLUSH]  = "ssd1306_flush",
+    [PROF_E32_RX_EVENT]   = "e32_rx_event",
+};
+
+void prof_init(void)
+{
+#if defined(__arm__)
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+#endif
+    prof_reset();
+}
+
+uint32_t prof_now(void)
+{
+#if defined(__arm__)
+    return DWT->CYCCNT;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)((uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec);
+#endif
+}
+
+/* Called from thread and interrupt context, but each probe id is only ever
+   used from one of them */
+void prof_record(prof_id_t id, uint32_t elapsed)
+{
+    if (id >= PROF_COUNT) return;
+    prof_entry_t *e = &prof_table[id];
+
+    if (e->count == 0 || elapsed < e->min) e->min = elapsed;
+    if (elapsed > e->max) e->max = elapsed;
+    e->total += elapsed;
+    e->count++;
+}
+
+void prof_reset(void)
+{
+    for (uint8_t i = 0; i < PROF_COUNT; i++) {
+        prof_table[i].count = 0;
+        prof_table[i].min = 0;
+        prof_table[i].max = 0;
+        prof_table[i].total = 0;
+    }
+}
+
+/* Append "<sep><value>" at p, return the new end */
+static char *prof_put_u32(char *p, char sep, uint32_t v)
+{
+    char tmp[10];
+    uint8_t n = 0;
+    *p++ = sep;
+    do {
+        tmp[n++] = (char)('0' + v % 10);
+        v /= 10;
+    } while (v != 0);
+    while (n > 0) *p++ = tmp[--n];
+    return p;
+}
+
+void prof_dump(void (*out)(const char *line))
+{
+    char line[80];
+
+    if (out == NULL) return;
+#if defined(__arm__)
+    out("probe count min max mean (cycles)\n");
+#else
+    out("probe count min max mean (ns)\n");
+#endif
+
+    for (uint8_t i = 0; i < PROF_COUNT; i++) {
+        const prof_entry_t *e = &prof_table[i];
+        if (e->count == 0) continue;
+
+        char *p = line;
+        for (const char *s = prof_names[i]; *s; s++) *p++ = *s;
+        p = prof_put_u32(p, ' ', e->count);
+        p = prof_put_u32(p, ' ', e->min);
+        p = prof_put_u32(p, ' ', e->max);
+        p = prof_put_u32(p, ' ', (uint32_t)(e->total / e->count));
+        *p++ = '\n';
+        *p = '\0';
+        out(line);
+    }
+}
+
+#endif /* PROF_ENABLE */
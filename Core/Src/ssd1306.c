@@ -1,328 +1,924 @@
 #include "ssd1306.h"
+#include "prof.h"
+#include "fixfmt.h"
 #include <string.h>
 
 /* External HAL I2C handle from the main project */
 extern I2C_HandleTypeDef hi2c1;
 
-/* Fonts are provided in other translation units (user code) */
-extern const uint8_t font5x8[FONT_COUNT][5];
-extern const uint16_t Font7x10[]; /* FONT7X10_ROWS uint16_t per glyph */
+#if SSD1306_USE_FRAMEBUFFER
+/* Shadow of the panel GDDRAM, one row of bytes per page */
+static uint8_t ssd1306_fb[SSD1306_PAGES][SSD1306_WIDTH];
 
-/* Internal constants for 7x10 conversion */
-#ifndef FONT7X10_ROWS
-#define FONT7X10_ROWS 10
+/* Dirty column span per page; dirty_x0 > dirty_x1 means the page is clean.
+   Clean from reset, so a flush before ssd1306_init() sends nothing. */
+static uint8_t ssd1306_dirty_x0[SSD1306_PAGES] = { 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF };
+static uint8_t ssd1306_dirty_x1[SSD1306_PAGES] = { 0 };
+
+static void ssd1306_mark_dirty(uint8_t page, uint8_t x0, uint8_t x1)
+{
+    if (x0 < ssd1306_dirty_x0[page]) ssd1306_dirty_x0[page] = x0;
+    if (x1 > ssd1306_dirty_x1[page]) ssd1306_dirty_x1[page] = x1;
+}
+
+/* Set when ssd1306_start_line has not been sent yet; the next flush sends it
+   after the data so rows scrolled in are already updated when they show */
+static uint8_t ssd1306_start_pending;
 #endif
-#ifndef FONT7X10_COLS
-#define FONT7X10_COLS 7
+
+/* Display start line (0x40 | n): RAM row shown at the top of the panel */
+static uint8_t ssd1306_start_line;
+
+#if SSD1306_USE_DMA
+/* Asynchronous transfer state, advanced from the I2C completion interrupt */
+typedef enum {
+    SSD1306_XFER_IDLE = 0,
+    SSD1306_XFER_DATA,        /* single ssd1306_data_async() burst */
+    SSD1306_XFER_FLUSH_SETUP, /* cursor commands of the current flush page */
+    SSD1306_XFER_FLUSH_DATA,  /* column span of the current flush page */
+    SSD1306_XFER_FLUSH_START  /* pending start line after the last span */
+} ssd1306_xfer_state_t;
+
+static volatile ssd1306_xfer_state_t ssd1306_xfer_state = SSD1306_XFER_IDLE;
+static ssd1306_done_cb_t ssd1306_done_cb = NULL;
+
+#if SSD1306_USE_FRAMEBUFFER
+/* Spans taken from the dirty table when the async flush started. The dirty
+   table belongs to the thread and the xfer_* state to the interrupt while a
+   transfer is in flight: spans left here by a failed flush are merged back
+   by the thread (ssd1306_xfer_reclaim) once the state is idle again. */
+static uint8_t ssd1306_xfer_x0[SSD1306_PAGES] = { 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF };
+static uint8_t ssd1306_xfer_x1[SSD1306_PAGES] = { 0 };
+static uint8_t ssd1306_xfer_page;
+static uint8_t ssd1306_xfer_npages;
+static uint8_t ssd1306_xfer_cmd[6];
+/* Start line request taken with the spans: a set_start_line() issued while
+   the flush runs waits for the next flush, after its rows are sent */
+static uint8_t ssd1306_xfer_start;
+static uint8_t ssd1306_xfer_line;
 #endif
 
-/* Forward declarations of internal helpers */
-static int ssd1306_font7x10_find_bit_offset_internal(void);
-static void ssd1306_font7x10_glyph_to_pages_internal(const uint16_t glyph_rows[FONT7X10_ROWS],
-                                                     uint8_t out_page0[FONT7X10_COLS + 1],
-                                                     uint8_t out_page1[FONT7X10_COLS + 1],
-                                                     int bit_offset);
+static void ssd1306_xfer_finish(HAL_StatusTypeDef status);
+static HAL_StatusTypeDef ssd1306_xfer_next(void);
+#if SSD1306_USE_FRAMEBUFFER
+static HAL_StatusTypeDef ssd1306_xfer_start_page(void);
+#endif
+
+/* Block until the in-flight transfer completes (bounded by the I2C timeout) */
+static HAL_StatusTypeDef ssd1306_wait_idle(void)
+{
+    uint32_t start = HAL_GetTick();
+    while (ssd1306_xfer_state != SSD1306_XFER_IDLE) {
+        if ((HAL_GetTick() - start) > SSD1306_I2C_TIMEOUT_MS) return HAL_BUSY;
+    }
+    return HAL_OK;
+}
+#endif
 
 /* ----------------------------------------------------------------------------
    Low level I2C primitives
    ---------------------------------------------------------------------------- */
 
+/* Control byte (Co = 0): D/C# selects the command stream or GDDRAM data */
+#define SSD1306_CTRL_CMD  0x00
+#define SSD1306_CTRL_DATA 0x40
+
+#if SSD1306_USE_STATS
+static volatile ssd1306_stats_t ssd1306_stats;
+
+static void ssd1306_stats_count(uint16_t len, HAL_StatusTypeDef st)
+{
+    ssd1306_stats.transactions++;
+    ssd1306_stats.payload_bytes += (uint32_t)len + 1; /* + control byte */
+    if (st != HAL_OK) ssd1306_stats.errors++;
+}
+
+void ssd1306_stats_get(ssd1306_stats_t *stats)
+{
+    if (stats == NULL) return;
+    stats->transactions = ssd1306_stats.transactions;
+    stats->payload_bytes = ssd1306_stats.payload_bytes;
+    stats->errors = ssd1306_stats.errors;
+}
+
+void ssd1306_stats_reset(void)
+{
+    ssd1306_stats.transactions = 0;
+    ssd1306_stats.payload_bytes = 0;
+    ssd1306_stats.errors = 0;
+}
+
+uint32_t ssd1306_stats_bus_time_us(const ssd1306_stats_t *stats, uint32_t bus_hz)
+{
+    if (stats == NULL || bus_hz == 0) return 0;
+    /* address byte + START/STOP (~2 clocks) per transaction */
+    uint64_t clocks = (uint64_t)stats->payload_bytes * 9u + (uint64_t)stats->transactions * (9u + 2u);
+    return (uint32_t)((clocks * 1000000u + bus_hz - 1) / bus_hz);
+}
+#define SSD1306_STATS_COUNT(len, st) ssd1306_stats_count((len), (st))
+#else
+#define SSD1306_STATS_COUNT(len, st) ((void)0)
+#endif
+
+/* Transport seam: every transfer to the panel goes through these two
+   functions as one control byte followed by len payload bytes. The control
+   byte is sent as the 8-bit Mem_Write memory address, so buf goes out in
+   place (it may live in flash). */
+static HAL_StatusTypeDef ssd1306_bus_write(uint8_t control, const uint8_t *buf, uint16_t len)
+{
+    HAL_StatusTypeDef st = HAL_I2C_Mem_Write(&hi2c1, SSD1306_ADDR, control, I2C_MEMADD_SIZE_8BIT,
+                                             (uint8_t *)buf, len, SSD1306_I2C_TIMEOUT_MS);
+    SSD1306_STATS_COUNT(len, st);
+    return st;
+}
+
+#if SSD1306_USE_DMA
+static HAL_StatusTypeDef ssd1306_bus_write_dma(uint8_t control, const uint8_t *buf, uint16_t len)
+{
+    HAL_StatusTypeDef st = HAL_I2C_Mem_Write_DMA(&hi2c1, SSD1306_ADDR, control, I2C_MEMADD_SIZE_8BIT,
+                                                 (uint8_t *)buf, len);
+    SSD1306_STATS_COUNT(len, st);
+    return st;
+}
+#endif
+
 /* Send one command byte (control byte = 0x00) */
 HAL_StatusTypeDef ssd1306_command(uint8_t cmd)
 {
-    uint8_t buf[2];
-    buf[0] = 0x00; /* Co = 0, D/C# = 0 -> command */
-    buf[1] = cmd;
-    return HAL_I2C_Master_Transmit(&hi2c1, SSD1306_ADDR, buf, 2, SSD1306_I2C_TIMEOUT_MS);
+    return ssd1306_commands(&cmd, 1);
+}
+
+/* Send a command stream: one control byte 0x00 (Co = 0, D/C# = 0) followed by
+   all command bytes, in a single transaction. */
+HAL_StatusTypeDef ssd1306_commands(const uint8_t *cmds, size_t n)
+{
+    if (cmds == NULL || n == 0) return HAL_OK;
+    if (n > 0xFFFF) return HAL_ERROR;
+#if SSD1306_USE_DMA
+    if (ssd1306_wait_idle() != HAL_OK) return HAL_BUSY;
+#endif
+    return ssd1306_bus_write(SSD1306_CTRL_CMD, cmds, (uint16_t)n);
 }
 
-/* Send data buffer with control byte 0x40. This implementation chunks the
-   payload to SSD1306_I2C_CHUNK_SIZE bytes per transfer. */
-HAL_StatusTypeDef ssd1306_data(uint8_t *data, uint16_t size)
+/* Send data with control byte 0x40 (Co = 0, D/C# = 1), streamed straight
+   from the caller's buffer. With SSD1306_I2C_CHUNK_SIZE set, the payload is
+   split into transactions of at most that many bytes. */
+HAL_StatusTypeDef ssd1306_data(const uint8_t *data, uint16_t size)
 {
     if (data == NULL || size == 0) return HAL_OK;
+#if SSD1306_USE_DMA
+    if (ssd1306_wait_idle() != HAL_OK) return HAL_BUSY;
+#endif
 
-    uint8_t txbuf[SSD1306_I2C_CHUNK_SIZE + 1];
     uint16_t sent = 0;
     HAL_StatusTypeDef status = HAL_OK;
+    PROF_BEGIN(PROF_SSD1306_DATA);
 
     while (sent < size) {
-        uint16_t chunk = (uint16_t)((size - sent) > SSD1306_I2C_CHUNK_SIZE ? SSD1306_I2C_CHUNK_SIZE : (size - sent));
-        txbuf[0] = 0x40; /* Co = 0, D/C# = 1 -> data */
-        memcpy(&txbuf[1], &data[sent], chunk);
+        uint16_t chunk = (uint16_t)(size - sent);
+#if SSD1306_I2C_CHUNK_SIZE > 0
+        if (chunk > SSD1306_I2C_CHUNK_SIZE) chunk = SSD1306_I2C_CHUNK_SIZE;
+#endif
 
         int attempt;
         for (attempt = 0; attempt <= SSD1306_I2C_RETRIES; attempt++) {
-            status = HAL_I2C_Master_Transmit(&hi2c1, SSD1306_ADDR, txbuf, (uint16_t)(chunk + 1), SSD1306_I2C_TIMEOUT_MS);
+            status = ssd1306_bus_write(SSD1306_CTRL_DATA, &data[sent], chunk);
             if (status == HAL_OK) break;
             HAL_Delay(5);
         }
 
-        if (status != HAL_OK) return status;
+        if (status != HAL_OK) break;
 
         sent += chunk;
     }
 
+    PROF_END(PROF_SSD1306_DATA);
+    return status;
+}
+
+#if SSD1306_USE_FRAMEBUFFER
+/* Number of pages from page on that go out as one window: a run of
+   consecutive full-width spans is contiguous in ssd1306_fb and is sent as a
+   single transaction, any other span on its own */
+static uint8_t ssd1306_span_pages(const uint8_t *x0, const uint8_t *x1, uint8_t page)
+{
+    uint8_t n = 1;
+    if (x0[page] != 0 || x1[page] != SSD1306_WIDTH - 1) return n;
+    while (page + n < SSD1306_PAGES && x0[page + n] == 0 && x1[page + n] == SSD1306_WIDTH - 1) n++;
+    return n;
+}
+#endif
+
+#if SSD1306_USE_DMA
+/* ----------------------------------------------------------------------------
+   Asynchronous (DMA) transport
+   ---------------------------------------------------------------------------- */
+
+uint8_t ssd1306_busy(void)
+{
+    return ssd1306_xfer_state != SSD1306_XFER_IDLE;
+}
+
+void ssd1306_set_done_callback(ssd1306_done_cb_t cb)
+{
+    ssd1306_done_cb = cb;
+}
+
+/* The payload is streamed straight from the caller's buffer */
+HAL_StatusTypeDef ssd1306_data_async(const uint8_t *data, uint16_t size)
+{
+    if (data == NULL || size == 0) return HAL_OK;
+    if (ssd1306_xfer_state != SSD1306_XFER_IDLE) return HAL_BUSY;
+
+    ssd1306_xfer_state = SSD1306_XFER_DATA;
+    HAL_StatusTypeDef st = ssd1306_bus_write_dma(SSD1306_CTRL_DATA, data, size);
+    if (st != HAL_OK) ssd1306_xfer_state = SSD1306_XFER_IDLE;
+    return st;
+}
+
+#if SSD1306_USE_FRAMEBUFFER
+/* Thread context, transfer idle: return the spans and the start line a
+   failed flush did not send to the dirty table */
+static void ssd1306_xfer_reclaim(void)
+{
+    for (uint8_t page = 0; page < SSD1306_PAGES; page++) {
+        if (ssd1306_xfer_x0[page] > ssd1306_xfer_x1[page]) continue;
+        ssd1306_mark_dirty(page, ssd1306_xfer_x0[page], ssd1306_xfer_x1[page]);
+        ssd1306_xfer_x0[page] = 0xFF;
+        ssd1306_xfer_x1[page] = 0x00;
+    }
+    if (ssd1306_xfer_start) {
+        ssd1306_xfer_start = 0;
+        ssd1306_start_pending = 1;
+    }
+}
+
+/* Only the thread touches the dirty table, so it is copied without masking
+   interrupts; the completion interrupt sees the copy once the state leaves
+   idle. With nothing to send no transfer is started and the done callback
+   is not called. */
+HAL_StatusTypeDef ssd1306_flush_async(void)
+{
+    if (ssd1306_xfer_state != SSD1306_XFER_IDLE) return HAL_BUSY;
+    __DMB();
+    ssd1306_xfer_reclaim();
+
+    ssd1306_xfer_start = ssd1306_start_pending;
+    ssd1306_xfer_line = ssd1306_start_line;
+    ssd1306_start_pending = 0;
+
+    uint8_t dirty = ssd1306_xfer_start;
+    for (uint8_t page = 0; page < SSD1306_PAGES; page++) {
+        if (ssd1306_dirty_x0[page] <= ssd1306_dirty_x1[page]) dirty = 1;
+        ssd1306_xfer_x0[page] = ssd1306_dirty_x0[page];
+        ssd1306_xfer_x1[page] = ssd1306_dirty_x1[page];
+        ssd1306_dirty_x0[page] = 0xFF;
+        ssd1306_dirty_x1[page] = 0x00;
+    }
+    if (!dirty) return HAL_OK;
+
+    ssd1306_xfer_page = 0;
+    HAL_StatusTypeDef st = ssd1306_xfer_start_page();
+    if (st != HAL_OK) ssd1306_xfer_finish(st);
+    return st;
+}
+
+/* Send the window setup of the first pending span at or after
+   ssd1306_xfer_page, or complete the flush when none is left */
+static HAL_StatusTypeDef ssd1306_xfer_start_page(void)
+{
+    while (ssd1306_xfer_page < SSD1306_PAGES &&
+           ssd1306_xfer_x0[ssd1306_xfer_page] > ssd1306_xfer_x1[ssd1306_xfer_page]) {
+        ssd1306_xfer_page++;
+    }
+    if (ssd1306_xfer_page >= SSD1306_PAGES) {
+        if (ssd1306_xfer_start) {
+            ssd1306_xfer_cmd[0] = (uint8_t)(0x40 | ssd1306_xfer_line);
+            ssd1306_xfer_state = SSD1306_XFER_FLUSH_START;
+            return ssd1306_bus_write_dma(SSD1306_CTRL_CMD, ssd1306_xfer_cmd, 1);
+        }
+        ssd1306_xfer_finish(HAL_OK);
+        return HAL_OK;
+    }
+
+    uint8_t page = ssd1306_xfer_page;
+    ssd1306_xfer_npages = ssd1306_span_pages(ssd1306_xfer_x0, ssd1306_xfer_x1, page);
+    ssd1306_xfer_cmd[0] = 0x21; /* column address range */
+    ssd1306_xfer_cmd[1] = ssd1306_xfer_x0[page];
+    ssd1306_xfer_cmd[2] = ssd1306_xfer_x1[page];
+    ssd1306_xfer_cmd[3] = 0x22; /* page address range */
+    ssd1306_xfer_cmd[4] = page;
+    ssd1306_xfer_cmd[5] = (uint8_t)(page + ssd1306_xfer_npages - 1);
+    ssd1306_xfer_state = SSD1306_XFER_FLUSH_SETUP;
+    return ssd1306_bus_write_dma(SSD1306_CTRL_CMD, ssd1306_xfer_cmd, sizeof(ssd1306_xfer_cmd));
+}
+#endif
+
+/* Called when a DMA step completed: start the next one or finish */
+static HAL_StatusTypeDef ssd1306_xfer_next(void)
+{
+#if SSD1306_USE_FRAMEBUFFER
+    uint8_t page = ssd1306_xfer_page;
+
+    if (ssd1306_xfer_state == SSD1306_XFER_FLUSH_SETUP) {
+        uint8_t x0 = ssd1306_xfer_x0[page];
+        uint16_t len = (uint16_t)((ssd1306_xfer_x1[page] - x0 + 1) * ssd1306_xfer_npages);
+        ssd1306_xfer_state = SSD1306_XFER_FLUSH_DATA;
+        return ssd1306_bus_write_dma(SSD1306_CTRL_DATA, &ssd1306_fb[page][x0], len);
+    }
+
+    if (ssd1306_xfer_state == SSD1306_XFER_FLUSH_DATA) {
+        for (uint8_t p = 0; p < ssd1306_xfer_npages; p++) {
+            ssd1306_xfer_x0[page + p] = 0xFF;
+            ssd1306_xfer_x1[page + p] = 0x00;
+        }
+        ssd1306_xfer_page = (uint8_t)(page + ssd1306_xfer_npages);
+        return ssd1306_xfer_start_page();
+    }
+
+    if (ssd1306_xfer_state == SSD1306_XFER_FLUSH_START) ssd1306_xfer_start = 0;
+#endif
+
+    ssd1306_xfer_finish(HAL_OK);
     return HAL_OK;
 }
 
+/* Return to idle and report. On error the spans that did not make it to the
+   panel stay in ssd1306_xfer_x0/x1 and ssd1306_xfer_start; the next flush
+   merges them back. */
+static void ssd1306_xfer_finish(HAL_StatusTypeDef status)
+{
+    __DMB();
+    ssd1306_xfer_state = SSD1306_XFER_IDLE;
+    if (ssd1306_done_cb != NULL) ssd1306_done_cb(status);
+}
+
+void HAL_I2C_MemTxCpltCallback(I2C_HandleTypeDef *hi2c)
+{
+    if (hi2c != &hi2c1 || ssd1306_xfer_state == SSD1306_XFER_IDLE) return;
+
+    HAL_StatusTypeDef st = ssd1306_xfer_next();
+    if (st != HAL_OK) ssd1306_xfer_finish(st);
+}
+
+void HAL_I2C_ErrorCallback(I2C_HandleTypeDef *hi2c)
+{
+    if (hi2c != &hi2c1 || ssd1306_xfer_state == SSD1306_XFER_IDLE) return;
+
+#if SSD1306_USE_STATS
+    ssd1306_stats.errors++;
+#endif
+    ssd1306_xfer_finish(HAL_ERROR);
+}
+#endif
+
 /* ----------------------------------------------------------------------------
    Cursor control
    ---------------------------------------------------------------------------- */
 
-/* Set page (0..7) and column (0..127) for subsequent data writes */
+/* Set page (0..7) and column (0..127) for subsequent data writes. The window
+   extends to the bottom-right corner of the panel. */
 void ssd1306_set_cursor(uint8_t page, uint8_t col)
 {
     if (page > 7) page = 7;
     if (col  > 127) col = 127;
 
-    /* Page address B0h..B7h */
-    ssd1306_command(0xB0 | (page & 0x07));
+    ssd1306_set_window(col, 127, page, 7);
+}
 
-    /* Lower column address (0..15) */
-    ssd1306_command(0x00 | (col & 0x0F));
+HAL_StatusTypeDef ssd1306_set_start_line(uint8_t line)
+{
+    line &= 0x3F;
+    if (line == ssd1306_start_line) return HAL_OK;
+    ssd1306_start_line = line;
+#if SSD1306_USE_FRAMEBUFFER
+    ssd1306_start_pending = 1;
+    return HAL_OK;
+#else
+    return ssd1306_command((uint8_t)(0x40 | line));
+#endif
+}
 
-    /* Higher column address (0..7) */
-    ssd1306_command(0x10 | ((col >> 4) & 0x0F));
+uint8_t ssd1306_get_start_line(void)
+{
+    return ssd1306_start_line;
+}
+
+HAL_StatusTypeDef ssd1306_set_window(uint8_t col0, uint8_t col1, uint8_t page0, uint8_t page1)
+{
+    if (col1 > 127) col1 = 127;
+    if (page1 > 7) page1 = 7;
+    if (col0 > col1) col0 = col1;
+    if (page0 > page1) page0 = page1;
+
+    PROF_BEGIN(PROF_SSD1306_WINDOW);
+    uint8_t cmds[6];
+    cmds[0] = 0x21;  /* column address: start, end */
+    cmds[1] = col0;
+    cmds[2] = col1;
+    cmds[3] = 0x22;  /* page address: start, end */
+    cmds[4] = page0;
+    cmds[5] = page1;
+    HAL_StatusTypeDef st = ssd1306_commands(cmds, sizeof(cmds));
+    PROF_END(PROF_SSD1306_WINDOW);
+    return st;
 }
 
 /* ----------------------------------------------------------------------------
    High level display helpers
    ---------------------------------------------------------------------------- */
 
+/* Power-up sequence, sent as a single command stream */
+static const uint8_t ssd1306_init_cmds[] = {
+    0xAE,             /* Display OFF */
+    0x20, 0x00,       /* Memory addressing mode: Horizontal */
+    0xB0,             /* Page start address (B0h) */
+    0xC8,             /* COM Output Scan Direction: remapped */
+    0x00,             /* Low column address */
+    0x10,             /* High column address */
+    0x40,             /* Start line address */
+    0x81, 0x7F,       /* Contrast control */
+    0xA1,             /* Segment remap */
+    0xA6,             /* Normal display */
+    0xA8, 0x3F,       /* Multiplex ratio 1/64 */
+    0xA4,             /* Display follow RAM content */
+    0xD3, 0x00,       /* Display offset */
+    0xD5, 0x80,       /* Display clock divide/oscillator */
+    0xD9, 0xF1,       /* Pre-charge period */
+    0xDA, 0x12,       /* COM pins hw config */
+    0xDB, 0x40,       /* VCOMH deselect level */
+    0x8D, 0x14,       /* Charge pump setting (enable) */
+    0xAF,             /* Display ON */
+};
+
 void ssd1306_init(void)
 {
     HAL_Delay(50);
 
-    ssd1306_command(0xAE);             /* Display OFF */
-    ssd1306_command(0x20); ssd1306_command(0x00); /* Memory addressing mode: Horizontal */
-    ssd1306_command(0xB0);             /* Page start address (B0h) */
-    ssd1306_command(0xC8);             /* COM Output Scan Direction: remapped */
-    ssd1306_command(0x00);             /* Low column address */
-    ssd1306_command(0x10);             /* High column address */
-    ssd1306_command(0x40);             /* Start line address */
-    ssd1306_command(0x81); ssd1306_command(0x7F); /* Contrast control */
-    ssd1306_command(0xA1);             /* Segment remap */
-    ssd1306_command(0xA6);             /* Normal display */
-    ssd1306_command(0xA8); ssd1306_command(0x3F); /* Multiplex ratio 1/64 */
-    ssd1306_command(0xA4);             /* Display follow RAM content */
-    ssd1306_command(0xD3); ssd1306_command(0x00); /* Display offset */
-    ssd1306_command(0xD5); ssd1306_command(0x80); /* Display clock divide/oscillator */
-    ssd1306_command(0xD9); ssd1306_command(0xF1); /* Pre-charge period */
-    ssd1306_command(0xDA); ssd1306_command(0x12); /* COM pins hw config */
-    ssd1306_command(0xDB); ssd1306_command(0x40); /* VCOMH deselect level */
-    ssd1306_command(0x8D); ssd1306_command(0x14); /* Charge pump setting (enable) */
-    ssd1306_command(0xAF);             /* Display ON */
+#if SSD1306_USE_FRAMEBUFFER
+    memset(ssd1306_dirty_x0, 0xFF, sizeof(ssd1306_dirty_x0));
+    memset(ssd1306_dirty_x1, 0x00, sizeof(ssd1306_dirty_x1));
+    ssd1306_start_pending = 0;
+#endif
+    ssd1306_start_line = 0; /* the init sequence sends 0x40 */
+
+    ssd1306_commands(ssd1306_init_cmds, sizeof(ssd1306_init_cmds));
 
     HAL_Delay(10);
 }
 
-HAL_StatusTypeDef ssd1306_clear(void)
+#if !SSD1306_USE_FRAMEBUFFER
+/* One row of blank GDDRAM in flash, the source of every clear */
+static const uint8_t ssd1306_zero_row[SSD1306_WIDTH];
+
+/* Blank columns x0..x1 of pages page0..page1: one window, then the zero row
+   streamed until the window is filled */
+static HAL_StatusTypeDef ssd1306_zero_window(uint8_t x0, uint8_t x1, uint8_t page0, uint8_t page1)
 {
-    uint8_t line[128];
-    memset(line, 0x00, sizeof(line));
+    HAL_StatusTypeDef st = ssd1306_set_window(x0, x1, page0, page1);
+    uint16_t left = (uint16_t)((x1 - x0 + 1) * (page1 - page0 + 1));
 
-    for (uint8_t page = 0; page < 8; page++) {
-        ssd1306_set_cursor(page, 0);
-        HAL_StatusTypeDef st = ssd1306_data(line, sizeof(line));
-        if (st != HAL_OK) return st;
+    while (st == HAL_OK && left > 0) {
+        uint16_t n = (left > sizeof(ssd1306_zero_row)) ? sizeof(ssd1306_zero_row) : left;
+        st = ssd1306_data(ssd1306_zero_row, n);
+        left = (uint16_t)(left - n);
+    }
+    return st;
+}
+#endif
+
+HAL_StatusTypeDef ssd1306_clear(void)
+{
+    ssd1306_set_start_line(0);
+#if SSD1306_USE_FRAMEBUFFER
+    memset(ssd1306_fb, 0x00, sizeof(ssd1306_fb));
+    for (uint8_t page = 0; page < SSD1306_PAGES; page++) {
+        ssd1306_mark_dirty(page, 0, SSD1306_WIDTH - 1);
     }
     return HAL_OK;
+#else
+    return ssd1306_zero_window(0, SSD1306_WIDTH - 1, 0, SSD1306_PAGES - 1);
+#endif
 }
 
-/* ----------------------------------------------------------------------------
-   5x8 font rendering (font5x8)
-   ---------------------------------------------------------------------------- */
+HAL_StatusTypeDef ssd1306_clear_rect(uint8_t x, uint8_t y, uint8_t w, uint8_t h)
+{
+    if (w == 0 || h == 0 || x >= SSD1306_WIDTH || y >= SSD1306_PAGES * 8) return HAL_OK;
+    if (w > SSD1306_WIDTH - x) w = (uint8_t)(SSD1306_WIDTH - x);
+    if (h > SSD1306_PAGES * 8 - y) h = (uint8_t)(SSD1306_PAGES * 8 - y);
+
+    uint8_t x1 = (uint8_t)(x + w - 1);
+    uint8_t y1 = (uint8_t)(y + h - 1);
+    uint8_t page0 = y >> 3;
+    uint8_t page1 = y1 >> 3;
+
+#if SSD1306_USE_FRAMEBUFFER
+    for (uint8_t page = page0; page <= page1; page++) {
+        /* Rows of the rectangle within this page */
+        uint8_t top = (page == page0) ? (y & 7) : 0;
+        uint8_t bottom = (page == page1) ? (y1 & 7) : 7;
+        uint8_t keep = (uint8_t)~((0xFFu << top) & (0xFFu >> (7 - bottom)));
+        for (uint8_t col = x; col <= x1; col++) ssd1306_fb[page][col] &= keep;
+        ssd1306_mark_dirty(page, x, x1);
+    }
+    return HAL_OK;
+#else
+    return ssd1306_zero_window(x, x1, page0, page1);
+#endif
+}
 
-/* Write single 5x8 character (5 bytes + 1 spacing) at pixel col, page */
-HAL_StatusTypeDef ssd1306_write_char(uint8_t col, uint8_t page, char c)
+/* Send every dirty page span to the panel. Consecutive full-width pages share
+   one window and one data transaction, so a full frame is a single transfer.
+   A span that fails to transmit stays dirty so the next flush retries it. */
+HAL_StatusTypeDef ssd1306_flush(void)
 {
-    uint8_t uc = (uint8_t)c;
-    int index = (int)uc - FONT_FIRST_CHAR;
-    if (index < 0 || index >= FONT_COUNT) index = 0;
+    HAL_StatusTypeDef st = HAL_OK;
+#if SSD1306_USE_FRAMEBUFFER
+#if SSD1306_USE_DMA
+    if (ssd1306_wait_idle() != HAL_OK) return HAL_BUSY;
+    __DMB();
+    ssd1306_xfer_reclaim();
+#endif
+    PROF_BEGIN(PROF_SSD1306_FLUSH);
+    uint8_t page = 0;
+    while (page < SSD1306_PAGES) {
+        uint8_t x0 = ssd1306_dirty_x0[page];
+        uint8_t x1 = ssd1306_dirty_x1[page];
+        if (x0 > x1) {
+            page++;
+            continue;
+        }
 
-    uint8_t glyph[6];
-    memcpy(glyph, font5x8[index], 5);
-    glyph[5] = 0x00;
+        uint8_t n = ssd1306_span_pages(ssd1306_dirty_x0, ssd1306_dirty_x1, page);
+        st = ssd1306_set_window(x0, x1, page, (uint8_t)(page + n - 1));
+        if (st == HAL_OK) st = ssd1306_data(&ssd1306_fb[page][x0], (uint16_t)((x1 - x0 + 1) * n));
+        if (st != HAL_OK) break;
 
-    ssd1306_set_cursor(page, col);
-    return ssd1306_data(glyph, sizeof(glyph));
+        for (uint8_t p = 0; p < n; p++) {
+            ssd1306_dirty_x0[page + p] = 0xFF;
+            ssd1306_dirty_x1[page + p] = 0x00;
+        }
+        page = (uint8_t)(page + n);
+    }
+    if (st == HAL_OK && ssd1306_start_pending) {
+        st = ssd1306_command((uint8_t)(0x40 | ssd1306_start_line));
+        if (st == HAL_OK) ssd1306_start_pending = 0;
+    }
+    PROF_END(PROF_SSD1306_FLUSH);
+#endif
+    return st;
 }
 
-/* Write null-terminated string using 5x8 font. col in pixels, page 0..7 */
-HAL_StatusTypeDef ssd1306_write_string(uint8_t col, uint8_t page, const char *s)
+#if !(SSD1306_USE_DMA && SSD1306_USE_FRAMEBUFFER)
+HAL_StatusTypeDef ssd1306_flush_async(void)
+{
+    return ssd1306_flush();
+}
+#endif
+
+#if SSD1306_USE_FRAMEBUFFER
+const uint8_t *ssd1306_framebuffer(void)
 {
-    if (s == NULL) return HAL_OK;
-    uint8_t x = col;
+    return &ssd1306_fb[0][0];
+}
+
+/* P4 PBM: text header, then rows of WIDTH / 8 bytes, leftmost pixel in the
+   MSB, 1 = lit. Rows are taken from the start line on, as the panel shows
+   them. */
+void ssd1306_dump_pbm(ssd1306_write_fn_t out)
+{
+    static const char header[] = "P4\n128 64\n";
+    uint8_t row[SSD1306_WIDTH / 8];
+
+    if (out == NULL) return;
+    out((const uint8_t *)header, sizeof(header) - 1);
+
+    for (uint8_t y = 0; y < SSD1306_PAGES * 8; y++) {
+        uint8_t ry = (uint8_t)((y + ssd1306_start_line) & (SSD1306_PAGES * 8 - 1));
+        const uint8_t *line = ssd1306_fb[ry >> 3];
+        uint8_t bit = (uint8_t)(1u << (ry & 7));
+        for (uint8_t i = 0; i < sizeof(row); i++) {
+            uint8_t b = 0;
+            for (uint8_t k = 0; k < 8; k++) {
+                b = (uint8_t)(b << 1);
+                if (line[i * 8 + k] & bit) b |= 1;
+            }
+            row[i] = b;
+        }
+        out(row, sizeof(row));
+    }
+}
+#endif
 
-    while (*s) {
-        HAL_StatusTypeDef res = ssd1306_write_char(x, page, *s++);
-        if (res != HAL_OK) return res;
-        x += 6; /* 5 pixels glyph + 1 pixel spacing */
-        if (x >= 128) break;
+/* In framebuffer mode this only updates RAM; otherwise it is one window setup
+   plus one data burst. Columns beyond the right edge and pages below the
+   bottom are dropped (a clipped block is sent one page at a time). */
+HAL_StatusTypeDef ssd1306_write_block(uint8_t col, uint8_t page, uint8_t width, uint8_t pages,
+                                      const uint8_t *data)
+{
+    if (data == NULL || page >= SSD1306_PAGES || col >= SSD1306_WIDTH) return HAL_OK;
+    if (width == 0 || pages == 0) return HAL_OK;
+
+    uint8_t w = width;
+    uint8_t n = pages;
+    if (w > SSD1306_WIDTH - col) w = (uint8_t)(SSD1306_WIDTH - col);
+    if (n > SSD1306_PAGES - page) n = (uint8_t)(SSD1306_PAGES - page);
+
+#if SSD1306_USE_FRAMEBUFFER
+    for (uint8_t p = 0; p < n; p++) {
+        memcpy(&ssd1306_fb[page + p][col], &data[p * width], w);
+        ssd1306_mark_dirty((uint8_t)(page + p), col, (uint8_t)(col + w - 1));
     }
     return HAL_OK;
+#else
+    HAL_StatusTypeDef st;
+    if (w == width) {
+        st = ssd1306_set_window(col, (uint8_t)(col + w - 1), page, (uint8_t)(page + n - 1));
+        if (st != HAL_OK) return st;
+        return ssd1306_data(data, (uint16_t)(w * n));
+    }
+    for (uint8_t p = 0; p < n; p++) {
+        st = ssd1306_set_window(col, (uint8_t)(col + w - 1), (uint8_t)(page + p), (uint8_t)(page + p));
+        if (st == HAL_OK) st = ssd1306_data(&data[p * width], w);
+        if (st != HAL_OK) return st;
+    }
+    return HAL_OK;
+#endif
 }
 
 /* ----------------------------------------------------------------------------
-   7x10 custom font rendering (Font7x10)
+   Font rendering (ssd1306_font_t)
    ---------------------------------------------------------------------------- */
 
-/* Public wrapper for the internal bit-offset finder (returns 0..15) */
-int ssd1306_font7x10_find_bit_offset(void)
+#if !SSD1306_USE_FRAMEBUFFER
+/* Page-major block of one glyph run: up to 3 pages (16 rows + 7 bit shift)
+   by the full display width */
+static uint8_t ssd1306_run_buf[3 * SSD1306_WIDTH];
+#endif
+
+/* Glyph index of c, falling back to the first glyph (space) */
+static uint8_t ssd1306_glyph_index(const ssd1306_font_t *font, char c)
 {
-    return ssd1306_font7x10_find_bit_offset_internal();
+    int idx = (int)(uint8_t)c - font->first_char;
+    if (idx < 0 || idx >= font->count) idx = 0;
+    return (uint8_t)idx;
 }
 
-/* Write a single character from Font7x10. Character occupies two pages:
-   page and page+1. col in pixels (0..127). */
-HAL_StatusTypeDef ssd1306_write_char_from_Font7x10cust(uint8_t col, uint8_t page, char c)
+static uint8_t ssd1306_glyph_width(const ssd1306_font_t *font, uint8_t idx)
 {
-    static int bit_offset = -1;
-    if (bit_offset < 0) bit_offset = ssd1306_font7x10_find_bit_offset_internal();
+    return (font->widths != NULL) ? font->widths[idx] : font->width;
+}
 
-    int uc = (uint8_t)c;
-    int idx = uc - FONT7X10_FIRST_CHAR;
-    if (idx < 0 || idx >= FONT7X10_COUNT) idx = 0;
+/* Bits of glyph column col, bit n = glyph row n. Spacing columns are blank. */
+static uint32_t ssd1306_glyph_column(const ssd1306_font_t *font, uint8_t idx, uint8_t col)
+{
+    uint8_t w = ssd1306_glyph_width(font, idx);
+    if (col >= w) return 0;
 
-    const uint16_t *glyph_rows = &Font7x10[idx * FONT7X10_ROWS];
+    uint8_t pages = SSD1306_FONT_PAGES(font);
+    uint32_t offset = (font->offsets != NULL) ? font->offsets[idx] : (uint32_t)idx * w * pages;
+    const uint8_t *g = &font->bitmaps[offset];
 
-    uint8_t page0[FONT7X10_COLS + 1];
-    uint8_t page1[FONT7X10_COLS + 1];
-    memset(page0, 0x00, sizeof(page0));
-    memset(page1, 0x00, sizeof(page1));
+    uint32_t bits = 0;
+    for (uint8_t p = 0; p < pages; p++) {
+        bits |= (uint32_t)g[p * w + col] << (8 * p);
+    }
+    return bits;
+}
 
-    ssd1306_font7x10_glyph_to_pages_internal(glyph_rows, page0, page1, bit_offset);
+uint8_t ssd1306_glyph_advance(const ssd1306_font_t *font, char c)
+{
+    if (font == NULL) return 0;
+    return (uint8_t)(ssd1306_glyph_width(font, ssd1306_glyph_index(font, c)) + font->spacing);
+}
 
-    /* send top page (rows 0..7) */
-    ssd1306_set_cursor(page, col);
-    HAL_StatusTypeDef r = ssd1306_data(page0, FONT7X10_COLS + 1);
-    if (r != HAL_OK) return r;
+uint16_t ssd1306_text_width(const ssd1306_font_t *font, const char *s)
+{
+    uint16_t w = 0;
+    if (font == NULL || s == NULL) return 0;
+    while (*s) w += ssd1306_glyph_advance(font, *s++);
+    return w;
+}
 
-    /* send bottom page (rows 8..9 -> bits 0..1 within a byte) */
-    ssd1306_set_cursor(page + 1, col);
-    return ssd1306_data(page1, FONT7X10_COLS + 1);
+/* Compose one glyph cell (adv columns, npages pages) into dst, whose pages
+   are stride bytes apart. The glyph columns are shifted down by shift bits.
+   Framebuffer pixels outside the cell rows are preserved; the direct-mode
+   run buffer is written opaque. */
+static void ssd1306_compose_glyph(const ssd1306_font_t *font, uint8_t idx, uint8_t shift,
+                                  uint8_t npages, uint8_t adv, uint8_t *dst, uint16_t stride)
+{
+#if SSD1306_USE_FRAMEBUFFER
+    uint32_t mask = (((uint32_t)1 << font->height) - 1) << shift;
+#endif
+    PROF_BEGIN(PROF_SSD1306_GLYPH);
+
+    for (uint8_t col = 0; col < adv; col++) {
+        uint32_t bits = ssd1306_glyph_column(font, idx, col) << shift;
+        for (uint8_t p = 0; p < npages; p++) {
+            uint8_t b = (uint8_t)(bits >> (8 * p));
+            uint8_t *d = &dst[p * stride + col];
+#if SSD1306_USE_FRAMEBUFFER
+            uint8_t m = (uint8_t)(mask >> (8 * p));
+            *d = (uint8_t)((*d & ~m) | b);
+#else
+            *d = b;
+#endif
+        }
+    }
+    PROF_END(PROF_SSD1306_GLYPH);
 }
 
-/* Write string using 7x10 font. Each glyph width = FONT7X10_COLS + 1 spacing */
-HAL_StatusTypeDef ssd1306_write_string_7x10cust(uint8_t start_col, uint8_t page, const char *s)
+/* Draw the first n characters of s as one run at pixel (x, y), clipped at the
+   right edge. In framebuffer mode the glyphs go straight into the shadow
+   buffer; in direct mode the whole run is composed in ssd1306_run_buf and
+   sent with one window setup and one data stream. */
+static HAL_StatusTypeDef ssd1306_draw_run(const ssd1306_font_t *font, uint8_t x, uint8_t y,
+                                          const char *s, size_t n)
 {
-    if (s == NULL) return HAL_OK;
-    HAL_StatusTypeDef res = HAL_OK;
-    uint8_t x = start_col;
-    while (*s && (x + FONT7X10_COLS + 1) <= 128) {
-        res = ssd1306_write_char_from_Font7x10cust(x, page, *s++);
-        if (res != HAL_OK) return res;
-        x += (FONT7X10_COLS + 1);
+    if (font == NULL || s == NULL || x >= SSD1306_WIDTH || y >= SSD1306_PAGES * 8) return HAL_OK;
+
+    uint8_t shift = y & 7;
+    uint8_t page0 = y >> 3;
+    uint8_t page1 = (uint8_t)((y + font->height - 1) >> 3);
+    if (page1 >= SSD1306_PAGES) page1 = SSD1306_PAGES - 1;
+    uint8_t npages = (uint8_t)(page1 - page0 + 1);
+    uint8_t room = (uint8_t)(SSD1306_WIDTH - x);
+
+#if SSD1306_USE_FRAMEBUFFER
+    uint8_t *dst = &ssd1306_fb[page0][x];
+    const uint16_t stride = SSD1306_WIDTH;
+#else
+    /* Run width first: it is the page stride of the composed block */
+    uint16_t run_w = 0;
+    for (size_t i = 0; i < n && s[i] && run_w < room; i++) run_w += ssd1306_glyph_advance(font, s[i]);
+    if (run_w > room) run_w = room;
+    uint8_t *dst = ssd1306_run_buf;
+    const uint16_t stride = run_w;
+#endif
+
+    uint8_t used = 0;
+    for (size_t i = 0; i < n && s[i] && used < room; i++) {
+        uint8_t idx = ssd1306_glyph_index(font, s[i]);
+        uint8_t adv = (uint8_t)(ssd1306_glyph_width(font, idx) + font->spacing);
+        if (adv > room - used) adv = (uint8_t)(room - used);
+        ssd1306_compose_glyph(font, idx, shift, npages, adv, &dst[used], stride);
+        used = (uint8_t)(used + adv);
+    }
+    if (used == 0) return HAL_OK;
+
+#if SSD1306_USE_FRAMEBUFFER
+    for (uint8_t p = 0; p < npages; p++) {
+        ssd1306_mark_dirty((uint8_t)(page0 + p), x, (uint8_t)(x + used - 1));
     }
-    return res;
+    return HAL_OK;
+#else
+    return ssd1306_write_block(x, page0, used, npages, ssd1306_run_buf);
+#endif
+}
+
+/* Draw one glyph cell at pixel (x, y). The glyph columns are shifted down by
+   y % 8 and split across the 1..3 pages the cell overlaps. */
+HAL_StatusTypeDef ssd1306_draw_char(const ssd1306_font_t *font, uint8_t x, uint8_t y, char c)
+{
+    return ssd1306_draw_run(font, x, y, &c, 1);
+}
+
+HAL_StatusTypeDef ssd1306_draw_text(const ssd1306_font_t *font, uint8_t x, uint8_t y, const char *s)
+{
+    return ssd1306_draw_run(font, x, y, s, SIZE_MAX);
+}
+
+HAL_StatusTypeDef ssd1306_draw_textn(const ssd1306_font_t *font, uint8_t x, uint8_t y, const char *s,
+                                     size_t n)
+{
+    return ssd1306_draw_run(font, x, y, s, n);
 }
 
 /* ----------------------------------------------------------------------------
-   Internal helpers for 7x10 font conversion
+   5x8 font helpers (ssd1306_font_5x8)
    ---------------------------------------------------------------------------- */
 
-/* Find smallest set bit across all glyph rows to compute bit offset */
-static int ssd1306_font7x10_find_bit_offset_internal(void)
+/* Write single 5x8 character (5 bytes + 1 spacing) at pixel col, page */
+HAL_StatusTypeDef ssd1306_write_char(uint8_t col, uint8_t page, char c)
 {
-    for (int s = 0; s < FONT7X10_COUNT; s++) {
-        const uint16_t *g = &Font7x10[s * FONT7X10_ROWS];
-        for (int r = 0; r < FONT7X10_ROWS; r++) {
-            uint16_t v = g[r];
-            if (v == 0) continue;
-            for (int b = 0; b < 16; b++) {
-                if (v & (1u << b)) return b;
-            }
-        }
-    }
-    return 0;
-}
-
-/* Convert 10 rows of 16-bit-wide glyph data into two page buffers:
-   - out_page0: FONT7X10_COLS bytes mapping rows 0..7 into bits 0..7
-   - out_page1: FONT7X10_COLS bytes mapping rows 8..9 into bits 0..1
-   The final byte in each out_page is the empty spacing column (0x00).
-   This implementation mirrors the column order (6 - col) to match the
-   Font7x10 storage format used by the user.
-*/
-static void ssd1306_font7x10_glyph_to_pages_internal(const uint16_t glyph_rows[FONT7X10_ROWS],
-                                                     uint8_t out_page0[FONT7X10_COLS + 1],
-                                                     uint8_t out_page1[FONT7X10_COLS + 1],
-                                                     int bit_offset)
-{
-    for (int col = 0; col < FONT7X10_COLS; col++) {
-        uint8_t p0 = 0;
-        uint8_t p1 = 0;
-
-        /* top 8 rows -> bits 0..7 of p0 */
-        for (int row = 0; row < 8; row++) {
-            if (row < FONT7X10_ROWS) {
-                uint16_t rowval = glyph_rows[row];
-                uint16_t shifted = (uint16_t)(rowval >> bit_offset);
-                /* flip column order */
-                if (shifted & (1u << (6 - col))) p0 |= (1u << row);
-            }
-        }
+    if (page >= SSD1306_PAGES) return HAL_OK;
+    return ssd1306_draw_char(&ssd1306_font_5x8, col, (uint8_t)(page * 8), c);
+}
 
-        /* rows 8..9 -> bits 0..1 of p1 */
-        for (int row = 8; row < FONT7X10_ROWS; row++) {
-            uint16_t rowval = glyph_rows[row];
-            uint16_t shifted = (uint16_t)(rowval >> bit_offset);
-            if (shifted & (1u << (6 - col))) p1 |= (1u << (row - 8));
-        }
+/* Write null-terminated string using 5x8 font. col in pixels, page 0..7 */
+HAL_StatusTypeDef ssd1306_write_string(uint8_t col, uint8_t page, const char *s)
+{
+    if (page >= SSD1306_PAGES) return HAL_OK;
+    return ssd1306_draw_text(&ssd1306_font_5x8, col, (uint8_t)(page * 8), s);
+}
 
-        out_page0[col] = p0;
-        out_page1[col] = p1;
-    }
+/* ----------------------------------------------------------------------------
+   7x10 custom font helpers (ssd1306_font_7x10)
+   ---------------------------------------------------------------------------- */
 
-    /* spacing column */
-    out_page0[FONT7X10_COLS] = 0x00;
-    out_page1[FONT7X10_COLS] = 0x00;
+/* Write a single character from the pre-rotated 7x10 table. Character
+   occupies two pages: page and page+1. col in pixels (0..127). */
+HAL_StatusTypeDef ssd1306_write_char_from_Font7x10cust(uint8_t col, uint8_t page, char c)
+{
+    if (page >= SSD1306_PAGES) return HAL_OK;
+    return ssd1306_draw_char(&ssd1306_font_7x10, col, (uint8_t)(page * 8), c);
 }
 
-const uint8_t font5x8[FONT_COUNT][5] = { /* 0x20 ' ' */ {0x00,0x00,0x00,0x00,0x00}, /* 0x21 '!' */ {0x00,0x00,0x5F,0x00,0x00}, /* 0x22 '"' */ {0x00,0x07,0x00,0x07,0x00}, /* 0x23 '#' */ {0x14,0x7F,0x14,0x7F,0x14}, /* 0x24 '$' */ {0x24,0x2A,0x7F,0x2A,0x12}, /* 0x25 '%' */ {0x23,0x13,0x08,0x64,0x62}, /* 0x26 '&' */ {0x36,0x49,0x55,0x22,0x50}, /* 0x27 '\''*/ {0x00,0x05,0x03,0x00,0x00}, /* 0x28 '(' */ {0x00,0x1C,0x22,0x41,0x00}, /* 0x29 ')' */ {0x00,0x41,0x22,0x1C,0x00}, /* 0x2A '*' */ {0x14,0x08,0x3E,0x08,0x14}, /* 0x2B '+' */ {0x08,0x08,0x3E,0x08,0x08}, /* 0x2C ',' */ {0x00,0x50,0x30,0x00,0x00}, /* 0x2D '-' */ {0x08,0x08,0x08,0x08,0x08}, /* 0x2E '.' */ {0x00,0x60,0x60,0x00,0x00}, /* 0x2F '/' */ {0x20,0x10,0x08,0x04,0x02}, /* 0x30 '0' */ {0x3E,0x51,0x49,0x45,0x3E}, /* 0x31 '1' */ {0x00,0x42,0x7F,0x40,0x00}, /* 0x32 '2' */ {0x42,0x61,0x51,0x49,0x46}, /* 0x33 '3' */ {0x21,0x41,0x45,0x4B,0x31}, /* 0x34 '4' */ {0x18,0x14,0x12,0x7F,0x10}, /* 0x35 '5' */ {0x27,0x45,0x45,0x45,0x39}, /* 0x36 '6' */ {0x3C,0x4A,0x49,0x49,0x30}, /* 0x37 '7' */ {0x01,0x71,0x09,0x05,0x03}, /* 0x38 '8' */ {0x36,0x49,0x49,0x49,0x36}, /* 0x39 '9' */ {0x06,0x49,0x49,0x29,0x1E}, /* 0x3A ':' */ {0x00,0x36,0x36,0x00,0x00}, /* 0x3B ';' */ {0x00,0x56,0x36,0x00,0x00}, /* 0x3C '<' */ {0x08,0x14,0x22,0x41,0x00}, /* 0x3D '=' */ {0x14,0x14,0x14,0x14,0x14}, /* 0x3E '>' */ {0x00,0x41,0x22,0x14,0x08}, /* 0x3F '?' */ {0x02,0x01,0x51,0x09,0x06}, /* 0x40 '@' */ {0x32,0x49,0x79,0x41,0x3E}, /* 0x41 'A' */ {0x7E,0x11,0x11,0x11,0x7E}, /* 0x42 'B' */ {0x7F,0x49,0x49,0x49,0x36}, /* 0x43 'C' */ {0x3E,0x41,0x41,0x41,0x22}, /* 0x44 'D' */ {0x7F,0x41,0x41,0x22,0x1C}, /* 0x45 'E' */ {0x7F,0x49,0x49,0x49,0x41}, /* 0x46 'F' */ {0x7F,0x09,0x09,0x09,0x01}, /* 0x47 'G' */ {0x3E,0x41,0x49,0x49,0x7A}, /* 0x48 'H' */ {0x7F,0x08,0x08,0x08,0x7F}, /* 0x49 'I' */ {0x00,0x41,0x7F,0x41,0x00}, /* 0x4A 'J' */ {0x20,0x40,0x41,0x3F,0x01}, /* 0x4B 'K' */ {0x7F,0x08,0x14,0x22,0x41}, /* 0x4C 'L' */ {0x7F,0x40,0x40,0x40,0x40}, /* 0x4D 'M' */ {0x7F,0x02,0x0C,0x02,0x7F}, /* 0x4E 'N' */ {0x7F,0x04,0x08,0x10,0x7F}, /* 0x4F 'O' */ {0x3E,0x41,0x41,0x41,0x3E}, /* 0x50 'P' */ {0x7F,0x09,0x09,0x09,0x06}, /* 0x51 'Q' */ {0x3E,0x41,0x51,0x21,0x5E}, /* 0x52 'R' */ {0x7F,0x09,0x19,0x29,0x46}, /* 0x53 'S' */ {0x46,0x49,0x49,0x49,0x31}, /* 0x54 'T' */ {0x01,0x01,0x7F,0x01,0x01}, /* 0x55 'U' */ {0x3F,0x40,0x40,0x40,0x3F}, /* 0x56 'V' */ {0x1F,0x20,0x40,0x20,0x1F}, /* 0x57 'W' */ {0x7F,0x20,0x18,0x20,0x7F}, /* 0x58 'X' */ {0x63,0x14,0x08,0x14,0x63}, /* 0x59 'Y' */ {0x03,0x04,0x78,0x04,0x03}, /* 0x5A 'Z' */ {0x61,0x51,0x49,0x45,0x43}, /* 0x5B '[' */ {0x00,0x7F,0x41,0x41,0x00}, /* 0x5C '\' */ {0x02,0x04,0x08,0x10,0x20}, /* 0x5D ']' */ {0x00,0x41,0x41,0x7F,0x00}, /* 0x5E '^' */ {0x04,0x02,0x01,0x02,0x04}, /* 0x5F '_' */ {0x40,0x40,0x40,0x40,0x40}, /* 0x60 '`' */ {0x00,0x01,0x02,0x04,0x00}, /* 0x61 'a' */ {0x20,0x54,0x54,0x54,0x78}, /* 0x62 'b' */ {0x7F,0x48,0x44,0x44,0x38}, /* 0x63 'c' */ {0x38,0x44,0x44,0x44,0x20}, /* 0x64 'd' */ {0x38,0x44,0x44,0x48,0x7F}, /* 0x65 'e' */ {0x38,0x54,0x54,0x54,0x18}, /* 0x66 'f' */ {0x08,0x7E,0x09,0x01,0x02}, /* 0x67 'g' */ {0x0C,0x52,0x52,0x52,0x3E}, /* 0x68 'h' */ {0x7F,0x08,0x04,0x04,0x78}, /* 0x69 'i' */ {0x00,0x44,0x7D,0x40,0x00}, /* 0x6A 'j' */ {0x20,0x40,0x44,0x3D,0x00}, /* 0x6B 'k' */ {0x7F,0x10,0x28,0x44,0x00}, /* 0x6C 'l' */ {0x00,0x41,0x7F,0x40,0x00}, /* 0x6D 'm' */ {0x7C,0x04,0x18,0x04,0x78}, /* 0x6E 'n' */ {0x7C,0x08,0x04,0x04,0x78}, /* 0x6F 'o' */ {0x38,0x44,0x44,0x44,0x38}, /* 0x70 'p' */ {0x7C,0x14,0x14,0x14,0x08}, /* 0x71 'q' */ {0x08,0x14,0x14,0x18,0x7C}, /* 0x72 'r' */ {0x7C,0x08,0x04,0x04,0x08}, /* 0x73 's' */ {0x48,0x54,0x54,0x54,0x20}, /* 0x74 't' */ {0x04,0x3F,0x44,0x40,0x20}, /* 0x75 'u' */ {0x3C,0x40,0x40,0x20,0x7C}, /* 0x76 'v' */ {0x1C,0x20,0x40,0x20,0x1C}, /* 0x77 'w' */ {0x3C,0x40,0x30,0x40,0x3C}, /* 0x78 'x' */ {0x44,0x28,0x10,0x28,0x44}, /* 0x79 'y' */ {0x0C,0x50,0x50,0x50,0x3C}, /* 0x7A 'z' */ {0x44,0x64,0x54,0x4C,0x44}, /* 0x7B '{' */ {0x00,0x08,0x36,0x41,0x00}, /* 0x7C '|' */ {0x00,0x00,0x7F,0x00,0x00}, /* 0x7D '}' */ {0x00,0x41,0x36,0x08,0x00}, /* 0x7E '~' */ {0x02,0x01,0x02,0x04,0x02}, /* 0x7F DEL */ {0x00,0x06,0x09,0x09,0x06} };
+/* Write string using 7x10 font. Each glyph width = FONT7X10_COLS + 1 spacing */
+HAL_StatusTypeDef ssd1306_write_string_7x10cust(uint8_t start_col, uint8_t page, const char *s)
+{
+    if (s == NULL || page >= SSD1306_PAGES || start_col >= SSD1306_WIDTH) return HAL_OK;
 
+    /* Only whole glyphs are drawn */
+    size_t n = (size_t)(SSD1306_WIDTH - start_col) / (FONT7X10_COLS + 1);
+    return ssd1306_draw_run(&ssd1306_font_7x10, start_col, (uint8_t)(page * 8), s, n);
+}
 
-#include <stdio.h>
-#include <string.h>
-/* Допоміжна: форматування float у рядок з 6 знаками після коми без %f */
-static void ftoa6(float v, char *out, size_t out_len)
-{
-    if (!out || out_len == 0) return;
-    /* знак */
-    if (v < 0) {
-        v = -v;
-        if (out_len > 0) {
-            *out++ = '-';
-            out_len--;
+/* ----------------------------------------------------------------------------
+   Coordinates view
+   ---------------------------------------------------------------------------- */
+
+/* Three lines of fixed 7x10 text (16 cells each) on pages 0, 2 and 4, values
+   right-aligned so a changed fix only alters the trailing cells. The text last
+   drawn is kept per line; a 0 cell means "unknown" and is always redrawn. */
+#define SSD1306_COORD_LINES 3
+#define SSD1306_COORD_CELLS (SSD1306_WIDTH / (FONT7X10_COLS + 1))
+
+static char ssd1306_coord_text[SSD1306_COORD_LINES][SSD1306_COORD_CELLS];
+
+void Display_ResetCoordinates(void)
+{
+    memset(ssd1306_coord_text, 0, sizeof(ssd1306_coord_text));
+}
+
+/* Redraw the cells of one line that differ from what is on the panel, one
+   run per group of consecutive changed cells */
+static HAL_StatusTypeDef ssd1306_coord_line(uint8_t line, const char *value, size_t len)
+{
+    char text[SSD1306_COORD_CELLS];
+    char *prev = ssd1306_coord_text[line];
+    const uint8_t adv = FONT7X10_COLS + 1;
+    const uint8_t y = (uint8_t)(line * 16);
+    HAL_StatusTypeDef st = HAL_OK;
+
+    if (len > SSD1306_COORD_CELLS) len = SSD1306_COORD_CELLS;
+    memset(text, ' ', sizeof(text));
+    memcpy(&text[SSD1306_COORD_CELLS - len], value, len);
+
+    uint8_t i = 0;
+    while (i < SSD1306_COORD_CELLS) {
+        if (text[i] == prev[i]) {
+            i++;
+            continue;
+        }
+        uint8_t start = i;
+        while (i < SSD1306_COORD_CELLS && text[i] != prev[i]) i++;
+
+        HAL_StatusTypeDef r = ssd1306_draw_run(&ssd1306_font_7x10, (uint8_t)(start * adv), y,
+                                               &text[start], (size_t)(i - start));
+        if (r == HAL_OK) {
+            memcpy(&prev[start], &text[start], (size_t)(i - start));
+        } else {
+            st = r; /* cells stay stale and are retried on the next update */
         }
     }
-    uint32_t whole = (uint32_t)v;
-    float frac = v - (float)whole;
-    uint32_t frac6 = (uint32_t)(frac * 1000000.0f + 0.5f);
-    /* у випадку округлення, коли frac6 == 1000000 */
-    if (frac6 >= 1000000) {
-        whole += 1;
-        frac6 = 0;
-    }
-    /* формуємо рядок вручну */
-    char buf[24];
-    snprintf(buf, sizeof(buf), "%lu.%06lu", (unsigned long)whole, (unsigned long)frac6);
-    /* копіюємо з урахуванням довжини */
-    strncpy(out, buf, out_len - 1);
-    out[out_len - 1] = '\0';
+    return st;
+}
+
+HAL_StatusTypeDef Display_ShowCoordinatesE7(int32_t lat_e7, int32_t lon_e7, int32_t alt_dm)
+{
+    char buf[SSD1306_COORD_CELLS + 1];
+    HAL_StatusTypeDef st, r;
+    size_t n;
+
+    n = fixfmt_dm(buf, sizeof(buf), lat_e7, 'N', 'S');
+    st = ssd1306_coord_line(0, buf, n);
+
+    n = fixfmt_dm(buf, sizeof(buf), lon_e7, 'E', 'W');
+    r = ssd1306_coord_line(1, buf, n);
+    if (r != HAL_OK) st = r;
+
+    n = fixfmt_fixed(buf, sizeof(buf) - 2, alt_dm, 1);
+    buf[n++] = ' ';
+    buf[n++] = 'm';
+    r = ssd1306_coord_line(2, buf, n);
+    if (r != HAL_OK) st = r;
+
+    return st;
 }
 
-/* Перетворення у формат dd mm.mmm' (альтернативний варіант) */
-static void latlon_to_dms_str(float deg, char hemi, char *out, size_t out_len)
+/* Round v * scale to int32, saturating out-of-range values and NaN */
+static int32_t ssd1306_to_fixed(float v, float scale, int32_t limit)
 {
-    if (!out || out_len == 0) return;
-    char sign = (deg < 0) ? '-' : '+';
-    if (deg < 0) deg = -deg;
-    int d = (int)deg;
-    float minutes = (deg - d) * 60.0f;
-    int m_whole = (int)minutes;
-    int m_frac = (int)((minutes - m_whole) * 1000.0f + 0.5f); /* 3 знаки для хвилин */
-    snprintf(out, out_len, "%02d°%02d.%03d' %c", d, m_whole, m_frac, hemi);
+    v *= scale;
+    if (!(v > (float)-limit)) return -limit;
+    if (v >= (float)limit) return limit;
+    return (int32_t)(v + ((v < 0.0f) ? -0.5f : 0.5f));
 }
 
+void Display_ShowCoordinates(float lat, float lon, float alt)
+{
+    Display_ShowCoordinatesE7(ssd1306_to_fixed(lat, 1e7f, 900000000),
+                              ssd1306_to_fixed(lon, 1e7f, 1800000000),
+                              ssd1306_to_fixed(alt, 10.0f, 999999));
+}
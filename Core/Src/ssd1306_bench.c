@@ -0,0 +1,121 @@
+#include "ssd1306.h"
+
+#if SSD1306_USE_STATS
+
+/* Standard rendering workloads for comparing transport and renderer changes.
+   Each workload starts from reset counters and ends with a blocking flush,
+   so the numbers cover everything that reached the bus. */
+
+typedef void (*ssd1306_bench_fn_t)(void);
+
+static void bench_init(void)
+{
+    ssd1306_init();
+}
+
+static void bench_clear(void)
+{
+    ssd1306_clear();
+}
+
+/* 8 lines x 21 glyphs: a full screen of 5x8 text */
+static void bench_text_5x8(void)
+{
+    for (uint8_t page = 0; page < SSD1306_PAGES; page++) {
+        ssd1306_write_string(0, page, "0123456789ABCDEFGHIJK");
+    }
+}
+
+/* 4 lines x 16 glyphs of 7x10 text */
+static void bench_text_7x10(void)
+{
+    for (uint8_t page = 0; page < SSD1306_PAGES; page += 2) {
+        ssd1306_write_string_7x10cust(0, page, "0123456789ABCDEF");
+    }
+}
+
+/* One short field rewritten on an otherwise unchanged screen */
+static void bench_field_update(void)
+{
+    ssd1306_write_string(48, 3, "12.5");
+}
+
+/* Coordinates view drawn from scratch, then a following fix that moved a
+   few meters: only the trailing digits of each line are redrawn */
+static void bench_coords_full(void)
+{
+    Display_ResetCoordinates();
+    Display_ShowCoordinatesE7(498421300, 240299990, 2965);
+}
+
+static void bench_coords_update(void)
+{
+    Display_ShowCoordinatesE7(498421450, 240300120, 2967);
+}
+
+static const struct {
+    const char *name;
+    ssd1306_bench_fn_t run;
+} bench_workloads[] = {
+    { "init",         bench_init },
+    { "clear",        bench_clear },
+    { "text_5x8",     bench_text_5x8 },
+    { "text_7x10",    bench_text_7x10 },
+    { "field_update", bench_field_update },
+    { "coords_full",  bench_coords_full },
+    { "coords_update", bench_coords_update },
+};
+
+/* Append the decimal form of v at p, return the new end */
+static char *bench_put_u32(char *p, uint32_t v)
+{
+    char tmp[10];
+    uint8_t n = 0;
+    do {
+        tmp[n++] = (char)('0' + v % 10);
+        v /= 10;
+    } while (v != 0);
+    while (n > 0) *p++ = tmp[--n];
+    return p;
+}
+
+static char *bench_put_str(char *p, const char *s)
+{
+    while (*s) *p++ = *s++;
+    return p;
+}
+
+void ssd1306_bench_run(void (*out)(const char *line))
+{
+    static const uint32_t bus_hz[] = { 100000, 400000, 1000000 };
+    char line[96];
+    ssd1306_stats_t stats;
+
+    if (out == NULL) return;
+    out("workload,transactions,payload_bytes,us_100k,us_400k,us_1000k\n");
+
+    for (uint8_t i = 0; i < sizeof(bench_workloads) / sizeof(bench_workloads[0]); i++) {
+        ssd1306_flush();
+        ssd1306_stats_reset();
+        bench_workloads[i].run();
+        ssd1306_flush();
+        ssd1306_stats_get(&stats);
+
+        char *p = bench_put_str(line, bench_workloads[i].name);
+        *p++ = ',';
+        p = bench_put_u32(p, stats.transactions);
+        *p++ = ',';
+        p = bench_put_u32(p, stats.payload_bytes);
+        for (uint8_t k = 0; k < sizeof(bus_hz) / sizeof(bus_hz[0]); k++) {
+            *p++ = ',';
+            p = bench_put_u32(p, ssd1306_stats_bus_time_us(&stats, bus_hz[k]));
+        }
+        *p++ = '\n';
+        *p = '\0';
+        out(line);
+    }
+    /* The coordinates cache describes the bench's drawing, not the screen */
+    Display_ResetCoordinates();
+}
+
+#endif /* SSD1306_USE_STATS */
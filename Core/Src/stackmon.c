@@ -0,0 +1,107 @@
+#include "stackmon.h"
+#include "fixfmt.h"
+#include "stm32f1xx_hal.h"
+
+/* Bytes below the caller's stack pointer left unpainted: the frame of
+   stackmon_paint() itself */
+#define STACKMON_GUARD 32u
+
+/* Linker script symbols: only their addresses are meaningful */
+extern uint8_t _end;
+extern uint8_t _estack;
+extern uint8_t _Min_Heap_Size;
+extern uint8_t _Min_Stack_Size;
+
+#ifndef NO_HEAP
+/* sysmem.c; _sbrk(0) returns the current heap end */
+extern void *_sbrk(ptrdiff_t incr);
+#endif
+
+static uintptr_t stackmon_heap_end(void)
+{
+#ifdef NO_HEAP
+    return (uintptr_t)&_end;
+#else
+    return (uintptr_t)_sbrk(0);
+#endif
+}
+
+/* First word of the painted area, above the heap reservation and above
+   whatever the heap has grown to */
+static uint32_t *stackmon_floor(void)
+{
+    uintptr_t floor = (uintptr_t)&_end + (uintptr_t)&_Min_Heap_Size;
+    uintptr_t heap = stackmon_heap_end();
+    if (heap > floor) floor = heap;
+    return (uint32_t *)((floor + 3u) & ~(uintptr_t)3u);
+}
+
+/* Lowest word of the painted area the stack has written to */
+static uintptr_t stackmon_low_water(void)
+{
+    const uint32_t *p = stackmon_floor();
+    const uint32_t *top = (const uint32_t *)&_estack;
+
+    while (p < top && *p == STACKMON_PATTERN) p++;
+    return (uintptr_t)p;
+}
+
+void stackmon_paint(void)
+{
+    uint32_t *p = stackmon_floor();
+    uint32_t *top = (uint32_t *)(uintptr_t)((__get_MSP() - STACKMON_GUARD) & ~3u);
+
+    while (p < top) *p++ = STACKMON_PATTERN;
+}
+
+uint32_t stackmon_stack_used(void)
+{
+    return (uint32_t)((uintptr_t)&_estack - stackmon_low_water());
+}
+
+uint32_t stackmon_stack_reserved(void)
+{
+    return (uint32_t)(uintptr_t)&_Min_Stack_Size;
+}
+
+uint32_t stackmon_heap_used(void)
+{
+    return (uint32_t)(stackmon_heap_end() - (uintptr_t)&_end);
+}
+
+uint32_t stackmon_heap_reserved(void)
+{
+    return (uint32_t)(uintptr_t)&_Min_Heap_Size;
+}
+
+uint32_t stackmon_headroom(void)
+{
+    return (uint32_t)(stackmon_low_water() - (uintptr_t)stackmon_floor());
+}
+
+/* "label a / b\n" or "label a\n" when b is 0 */
+static void stackmon_line(void (*out)(const char *line), const char *label, uint32_t a, uint32_t b)
+{
+    char line[40];
+    char *p = line;
+
+    while (*label) *p++ = *label++;
+    p += fixfmt_u32(p, (size_t)(&line[sizeof(line)] - p), a);
+    if (b != 0) {
+        *p++ = ' ';
+        *p++ = '/';
+        *p++ = ' ';
+        p += fixfmt_u32(p, (size_t)(&line[sizeof(line)] - p), b);
+    }
+    *p++ = '\n';
+    *p = '\0';
+    out(line);
+}
+
+void stackmon_report(void (*out)(const char *line))
+{
+    if (out == NULL) return;
+    stackmon_line(out, "stack ", stackmon_stack_used(), stackmon_stack_reserved());
+    stackmon_line(out, "heap ", stackmon_heap_used(), stackmon_heap_reserved());
+    stackmon_line(out, "headroom ", stackmon_headroom(), 0);
+}
@@ -25,6 +25,10 @@
 #include <stdint.h>
 #include <stddef.h>
 
+/* NO_HEAP build: no _sbrk, so anything that needs the newlib heap fails to
+   link. Use the fixed-block pools of pool.h instead. */
+#ifndef NO_HEAP
+
 /**
  * Pointer to the current high watermark of the heap usage
  */
@@ -85,3 +89,5 @@ void *_sbrk(ptrdiff_t incr)
   // calls to `sbrk()` are resolved to our `_sbrk()` implementation.
   __strong_reference(_sbrk, sbrk);
 #endif
+
+#endif /* NO_HEAP */
@@ -0,0 +1,339 @@
+#include "e32_sim.h"
+#include "hal_stub.h"
+#include <string.h>
+
+#define SIM_M0      GPIO_PIN_13
+#define SIM_M1      GPIO_PIN_12
+#define SIM_AUX     GPIO_PIN_14
+#define SIM_NEVER   0xFFFFFFFFu
+
+/* M1 M0 as they are sampled */
+enum {
+    SIM_MODE_NORMAL = 0,
+    SIM_MODE_WAKEUP = 1,
+    SIM_MODE_POWERDOWN = 2,
+    SIM_MODE_PROGRAM = 3,
+    SIM_MODE_SWITCHING = 0xFF
+};
+
+#define SIM_PACKETS     8
+#define SIM_PACKET_MAX  256
+
+static const uint8_t sim_factory[6] = { 0xC0, 0x00, 0x00, 0x1A, 0x17, 0x44 };
+static const uint32_t sim_baud_table[8] = {
+    1200, 2400, 4800, 9600, 19200, 38400, 57600, 115200
+};
+
+e32_sim_t e32_sim;
+
+static USART_TypeDef sim_usart2;
+USART_TypeDef *const USART2 = &sim_usart2;
+static DMA_Channel_TypeDef sim_dma_tx_channel;
+static DMA_HandleTypeDef sim_hdma_tx = { &sim_dma_tx_channel };
+UART_HandleTypeDef huart2;
+
+static uint32_t sim_now;
+
+/* Transmission in flight */
+static uint8_t sim_tx_buf[SIM_PACKET_MAX];
+static uint16_t sim_tx_len;
+static uint32_t sim_tx_left;
+
+/* Reception armed by HAL_UARTEx_ReceiveToIdle_IT */
+static uint8_t *sim_rx_buf;
+static uint16_t sim_rx_size;
+static uint16_t sim_rx_pos;
+static HAL_UART_RxEventTypeTypeDef sim_rx_event;
+
+/* Packets on their way to the MCU, oldest first */
+static uint8_t sim_pkt[SIM_PACKETS][SIM_PACKET_MAX];
+static uint16_t sim_pkt_len[SIM_PACKETS];
+static uint32_t sim_pkt_at[SIM_PACKETS];
+static uint8_t sim_pkt_count;
+
+/* Module */
+static uint8_t sim_pins;
+static uint8_t sim_mode;
+static uint8_t sim_next_mode;
+static uint32_t sim_switch_at;
+static uint32_t sim_mode_at;
+static uint32_t sim_aux_high_at;
+static uint8_t sim_cmd[6];
+static uint8_t sim_cmd_len;
+
+static uint8_t sim_read_pins(void)
+{
+    return (uint8_t)((hal_stub_pin(GPIOB, SIM_M1) == GPIO_PIN_SET ? 2 : 0) |
+                     (hal_stub_pin(GPIOB, SIM_M0) == GPIO_PIN_SET ? 1 : 0));
+}
+
+static void sim_aux(uint8_t high)
+{
+    hal_stub_drive_pin(GPIOB, SIM_AUX, high ? GPIO_PIN_SET : GPIO_PIN_RESET);
+}
+
+/* USART2 frames bytes the way the module does: same baud rate, same parity
+   (program mode: 9600 8N1) */
+static uint8_t sim_link_ok(void)
+{
+    uint32_t baud = 9600;
+    uint32_t parity = UART_PARITY_NONE;
+
+    if (sim_mode != SIM_MODE_PROGRAM) {
+        uint8_t sped = e32_sim.params[3];
+        baud = sim_baud_table[(sped >> 3) & 0x07];
+        if ((sped >> 6) == 1) parity = UART_PARITY_ODD;
+        if ((sped >> 6) == 2) parity = UART_PARITY_EVEN;
+    }
+    uint32_t word = (parity == UART_PARITY_NONE) ? UART_WORDLENGTH_8B : UART_WORDLENGTH_9B;
+    uint32_t cr1 = huart2.Instance->CR1 & (USART_CR1_M | USART_CR1_PCE | USART_CR1_PS);
+    return huart2.Init.BaudRate == baud && huart2.Init.Parity == parity &&
+           huart2.Init.WordLength == word && cr1 == (word | parity);
+}
+
+static void sim_queue(const uint8_t *data, uint16_t len, uint32_t at)
+{
+    if (sim_pkt_count == SIM_PACKETS || len > SIM_PACKET_MAX) return;
+    memcpy(sim_pkt[sim_pkt_count], data, len);
+    sim_pkt_len[sim_pkt_count] = len;
+    sim_pkt_at[sim_pkt_count] = at;
+    sim_pkt_count++;
+}
+
+/* Bytes on the MCU's RX line, ended by an idle line */
+static void sim_rx_deliver(const uint8_t *data, uint16_t len)
+{
+    if (!sim_link_ok()) {
+        e32_sim.garbled += len;
+        return;
+    }
+    for (uint16_t i = 0; i < len; i++) {
+        if (huart2.RxState != HAL_UART_STATE_BUSY_RX) {
+            e32_sim.rx_lost++;
+            continue;
+        }
+        sim_rx_buf[sim_rx_pos++] = data[i];
+        if (sim_rx_pos == sim_rx_size) {
+            huart2.RxState = HAL_UART_STATE_READY;
+            sim_rx_event = HAL_UART_RXEVENT_TC;
+            HAL_UARTEx_RxEventCallback(&huart2, sim_rx_size);
+        }
+    }
+    if (huart2.RxState == HAL_UART_STATE_BUSY_RX && sim_rx_pos > 0) {
+        huart2.RxState = HAL_UART_STATE_READY;
+        sim_rx_event = HAL_UART_RXEVENT_IDLE;
+        HAL_UARTEx_RxEventCallback(&huart2, sim_rx_pos);
+    }
+}
+
+static void sim_program_command(void)
+{
+    uint8_t reply[6];
+
+    if (sim_cmd_len == 3 && sim_cmd[0] == 0xC1 && sim_cmd[1] == 0xC1 && sim_cmd[2] == 0xC1) {
+        memcpy(reply, e32_sim.params, sizeof(reply));
+        if (e32_sim.bad_reply) reply[0] = 0xFF;
+        sim_queue(reply, sizeof(reply), sim_now + e32_sim.cmd_ms);
+    } else if (sim_cmd_len == 6 && (sim_cmd[0] == 0xC0 || sim_cmd[0] == 0xC2)) {
+        memcpy(e32_sim.params, sim_cmd, sizeof(e32_sim.params));
+        e32_sim.params[0] = 0xC0;
+        if (sim_cmd[0] == 0xC0) memcpy(e32_sim.saved, e32_sim.params, sizeof(e32_sim.saved));
+        if (e32_sim.echo) {
+            uint32_t at = sim_now + e32_sim.cmd_ms;
+            if (e32_sim.echo_late_ms > 0) at += e32_sim.echo_late_ms;
+            sim_queue(sim_cmd, 6, at);
+        }
+    } else {
+        return;
+    }
+    e32_sim.commands++;
+    sim_cmd_len = 0;
+    sim_aux(0);
+    sim_aux_high_at = sim_now + e32_sim.cmd_ms;
+}
+
+/* A finished transmission reaches the module */
+static void sim_module_take(const uint8_t *data, uint16_t len)
+{
+    if (sim_mode == SIM_MODE_SWITCHING || sim_aux_high_at != SIM_NEVER ||
+        sim_mode == SIM_MODE_POWERDOWN || !sim_link_ok()) {
+        e32_sim.garbled += len;
+        return;
+    }
+
+    if (sim_mode == SIM_MODE_PROGRAM) {
+        for (uint16_t i = 0; i < len; i++) {
+            if (sim_cmd_len == sizeof(sim_cmd)) {
+                e32_sim.garbled += sim_cmd_len;
+                sim_cmd_len = 0;
+            }
+            sim_cmd[sim_cmd_len++] = data[i];
+            sim_program_command();
+        }
+        return;
+    }
+
+    for (uint16_t i = 0; i < len && e32_sim.air_len < E32_SIM_AIR_MAX; i++) {
+        e32_sim.air[e32_sim.air_len++] = data[i];
+    }
+    e32_sim.air_chunks++;
+    if (len > e32_sim.max_chunk) e32_sim.max_chunk = len;
+    sim_aux(0);
+    sim_aux_high_at = sim_now + e32_sim.air_ms;
+}
+
+static void sim_tx_done(void)
+{
+    uint16_t len = sim_tx_len;
+
+    sim_tx_len = 0;
+    USART2->SR |= UART_FLAG_TC;
+    huart2.gState = HAL_UART_STATE_READY;
+    if (e32_sim.tx_fail > 0) {
+        uint16_t sent = (e32_sim.tx_fail_sent < len) ? e32_sim.tx_fail_sent : len;
+        e32_sim.tx_fail--;
+        if (sent > 0) sim_module_take(sim_tx_buf, sent);
+        sim_dma_tx_channel.CNDTR = (uint32_t)(len - sent);
+        huart2.ErrorCode |= HAL_UART_ERROR_DMA;
+        HAL_UART_ErrorCallback(&huart2);
+        return;
+    }
+    sim_dma_tx_channel.CNDTR = 0;
+    sim_module_take(sim_tx_buf, len);
+    HAL_UART_TxCpltCallback(&huart2);
+}
+
+static void sim_tick(void)
+{
+    sim_now++;
+
+    if (sim_tx_len > 0 && --sim_tx_left == 0) sim_tx_done();
+
+    uint8_t pins = sim_read_pins();
+    if (pins != sim_pins) {
+        sim_pins = pins;
+        sim_switch_at = sim_now + e32_sim.aux_lag_ms;
+    }
+    if (sim_switch_at <= sim_now) {
+        sim_switch_at = SIM_NEVER;
+        sim_aux_high_at = SIM_NEVER;
+        sim_cmd_len = 0;
+        sim_mode = SIM_MODE_SWITCHING;
+        sim_next_mode = sim_pins;
+        sim_mode_at = sim_now + e32_sim.mode_ms;
+        sim_aux(0);
+    }
+    if (sim_mode_at <= sim_now) {
+        sim_mode_at = SIM_NEVER;
+        sim_mode = sim_next_mode;
+        sim_aux(1);
+    }
+
+    while (sim_pkt_count > 0 && sim_pkt_at[0] <= sim_now) {
+        uint8_t data[SIM_PACKET_MAX];
+        uint16_t len = sim_pkt_len[0];
+        memcpy(data, sim_pkt[0], len);
+        sim_pkt_count--;
+        memmove(sim_pkt[0], sim_pkt[1], (size_t)sim_pkt_count * SIM_PACKET_MAX);
+        memmove(&sim_pkt_len[0], &sim_pkt_len[1], sim_pkt_count * sizeof(sim_pkt_len[0]));
+        memmove(&sim_pkt_at[0], &sim_pkt_at[1], sim_pkt_count * sizeof(sim_pkt_at[0]));
+        sim_rx_deliver(data, len);
+    }
+    if (sim_aux_high_at <= sim_now) {
+        sim_aux_high_at = SIM_NEVER;
+        sim_aux(1);
+    }
+}
+
+void e32_sim_reset(void)
+{
+    memset(&e32_sim, 0, sizeof(e32_sim));
+    e32_sim.aux_lag_ms = 1;
+    e32_sim.mode_ms = 20;
+    e32_sim.cmd_ms = 10;
+    e32_sim.air_ms = 5;
+    e32_sim.echo = 1;
+    memcpy(e32_sim.params, sim_factory, sizeof(e32_sim.params));
+    memcpy(e32_sim.saved, sim_factory, sizeof(e32_sim.saved));
+
+    huart2.Instance = USART2;
+    huart2.hdmatx = &sim_hdma_tx;
+    huart2.Init.BaudRate = 9600;
+    huart2.Init.WordLength = UART_WORDLENGTH_8B;
+    huart2.Init.Parity = UART_PARITY_NONE;
+    USART2->CR1 = USART_CR1_UE;
+    huart2.gState = HAL_UART_STATE_READY;
+    huart2.RxState = HAL_UART_STATE_READY;
+    huart2.ErrorCode = HAL_UART_ERROR_NONE;
+    USART2->SR = UART_FLAG_TC;
+    sim_tx_len = 0;
+    sim_pkt_count = 0;
+
+    sim_pins = sim_read_pins();
+    sim_mode = sim_pins;
+    sim_switch_at = SIM_NEVER;
+    sim_mode_at = SIM_NEVER;
+    sim_aux_high_at = SIM_NEVER;
+    sim_cmd_len = 0;
+    sim_aux(1);
+
+    hal_stub_on_tick(sim_tick);
+}
+
+void e32_sim_receive(const uint8_t *data, uint16_t len)
+{
+    sim_queue(data, len, sim_now + 1);
+}
+
+void e32_sim_rx_error(uint32_t error_code)
+{
+    huart2.ErrorCode |= error_code;
+    if (error_code & HAL_UART_ERROR_ORE) huart2.RxState = HAL_UART_STATE_READY;
+    HAL_UART_ErrorCallback(&huart2);
+}
+
+/* --- HAL ----------------------------------------------------------------- */
+
+uint32_t HAL_RCC_GetPCLK1Freq(void)
+{
+    return 36000000;
+}
+
+HAL_StatusTypeDef HAL_UART_Transmit_DMA(UART_HandleTypeDef *huart, const uint8_t *pData, uint16_t Size)
+{
+    if (huart->gState != HAL_UART_STATE_READY) return HAL_BUSY;
+    if (pData == NULL || Size == 0 || Size > SIM_PACKET_MAX) return HAL_ERROR;
+    if (e32_sim.tx_refuse > 0) {
+        e32_sim.tx_refuse--;
+        return HAL_ERROR;
+    }
+
+    memcpy(sim_tx_buf, pData, Size);
+    sim_tx_len = Size;
+    sim_dma_tx_channel.CNDTR = Size;
+    sim_tx_left = ((uint32_t)Size * 10000u + huart->Init.BaudRate - 1) / huart->Init.BaudRate;
+    if (sim_tx_left == 0) sim_tx_left = 1;
+    huart->ErrorCode = HAL_UART_ERROR_NONE;
+    huart->gState = HAL_UART_STATE_BUSY_TX;
+    huart->Instance->SR &= ~UART_FLAG_TC;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_UARTEx_ReceiveToIdle_IT(UART_HandleTypeDef *huart, uint8_t *pData, uint16_t Size)
+{
+    if (huart->RxState != HAL_UART_STATE_READY) return HAL_BUSY;
+    if (pData == NULL || Size == 0) return HAL_ERROR;
+
+    sim_rx_buf = pData;
+    sim_rx_size = Size;
+    sim_rx_pos = 0;
+    huart->ErrorCode = HAL_UART_ERROR_NONE;
+    huart->RxState = HAL_UART_STATE_BUSY_RX;
+    return HAL_OK;
+}
+
+HAL_UART_RxEventTypeTypeDef HAL_UARTEx_GetRxEventType(UART_HandleTypeDef *huart)
+{
+    (void)huart;
+    return sim_rx_event;
+}
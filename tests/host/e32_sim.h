@@ -0,0 +1,68 @@
+#ifndef E32_SIM_H
+#define E32_SIM_H
+
+/* Host model of USART2 and an E32 LoRa module (M0 = PB13, M1 = PB12,
+   AUX = PB14), for e32.c.
+
+   UART: HAL_UART_Transmit_DMA only queues the bytes. They reach the module
+   after their time on the wire at the current BaudRate (10 bits per byte,
+   at least 1 ms), then HAL_UART_TxCpltCallback runs. Bytes from the module
+   land in the buffer armed by HAL_UARTEx_ReceiveToIdle_IT: a full buffer
+   ends with a TC event, the end of the packet with an IDLE event.
+
+   Module: M0/M1 are sampled every tick. aux_lag_ms after a change AUX falls,
+   mode_ms later the new mode is active and AUX rises. Bytes are only taken
+   while AUX is high and at the module's baud rate and parity (9600 8N1 in
+   program mode, the SPED setting otherwise); anything else is counted as
+   garbled, in both directions.
+     normal mode   every transmission goes on the air; AUX is low for
+                   air_ms afterwards
+     program mode  C1 C1 C1: AUX low for cmd_ms, reply C0 + 5 parameters,
+                   AUX high.
+                   C0/C2 + 5 bytes: parameters applied (C0 also to flash),
+                   AUX low for cmd_ms, echo of the block, AUX high. With
+                   echo_late_ms the echo comes that long after AUX rose. */
+
+#include <stdint.h>
+
+#define E32_SIM_AIR_MAX 1024
+
+typedef struct {
+    /* Behaviour, set by the test after e32_sim_reset() */
+    uint32_t aux_lag_ms;    /* M0/M1 change to AUX falling */
+    uint32_t mode_ms;       /* AUX low while the module switches mode */
+    uint32_t cmd_ms;        /* AUX low while a program-mode command runs */
+    uint32_t air_ms;        /* AUX low after a transmission in normal mode */
+    uint8_t echo;           /* echo C0/C2 blocks (default 1) */
+    uint32_t echo_late_ms;  /* echo this long after AUX rose, 0 = before */
+    uint8_t bad_reply;      /* C1 C1 C1 is answered with a wrong head byte */
+    uint32_t tx_fail;       /* the next n transmissions end in a DMA error */
+    uint16_t tx_fail_sent;  /* bytes of a failing transmission that still
+                               reached the UART (left in CNDTR: the rest) */
+    uint32_t tx_refuse;     /* the next n HAL_UART_Transmit_DMA calls fail */
+
+    /* Module state */
+    uint8_t params[6];      /* working parameters, HEAD = C0 */
+    uint8_t saved[6];       /* parameters in flash */
+    uint8_t air[E32_SIM_AIR_MAX];
+    uint32_t air_len;       /* bytes sent on the air */
+    uint32_t air_chunks;    /* transmissions that went on the air */
+    uint32_t max_chunk;     /* longest of them */
+    uint32_t commands;      /* program-mode commands answered */
+    uint32_t garbled;       /* bytes lost to a baud mismatch or busy module */
+    uint32_t rx_lost;       /* bytes for the MCU with no reception armed */
+} e32_sim_t;
+
+extern e32_sim_t e32_sim;
+
+/* Power-on: normal mode, AUX high, factory parameters C0 00 00 1A 17 44
+   (9600 8N1, 2.4k air, channel 0x17), USART2 at 9600 and idle */
+void e32_sim_reset(void);
+
+/* A packet from the air: delivered to the MCU on the next tick */
+void e32_sim_receive(const uint8_t *data, uint16_t len);
+
+/* UART receive error: ORE stops the reception, PE/NE/FE are only reported */
+void e32_sim_rx_error(uint32_t error_code);
+
+#endif /* E32_SIM_H */
@@ -0,0 +1,97 @@
+#include "hal_stub.h"
+#include "ssd1306_emu.h"
+
+/* Host time base. Every HAL_GetTick() call advances the clock by 1 ms and
+   then delivers the device "interrupts" that became due, unless PRIMASK is
+   set: busy-wait loops in the driver therefore see transfers complete the
+   same way they would on the target. */
+
+uint32_t hal_stub_primask;
+static uint32_t hal_stub_tick;
+
+#define HAL_STUB_MAX_TICKS 4
+static void (*hal_stub_ticks[HAL_STUB_MAX_TICKS])(void);
+
+/* GPIO: one level word per port, EXTI lines held back while masked */
+static GPIO_TypeDef hal_stub_ports[3] = { { 0 }, { 1 }, { 2 } };
+GPIO_TypeDef *const GPIOA = &hal_stub_ports[0];
+GPIO_TypeDef *const GPIOB = &hal_stub_ports[1];
+GPIO_TypeDef *const GPIOC = &hal_stub_ports[2];
+static uint16_t hal_stub_levels[3];
+static uint16_t hal_stub_exti_pending;
+
+static void hal_stub_irqs(void)
+{
+    if (hal_stub_primask) return;
+
+    emu_tick();
+    for (uint8_t i = 0; i < HAL_STUB_MAX_TICKS; i++) {
+        if (hal_stub_ticks[i] != NULL) hal_stub_ticks[i]();
+    }
+    while (hal_stub_exti_pending != 0) {
+        uint16_t pin = (uint16_t)(hal_stub_exti_pending & -hal_stub_exti_pending);
+        hal_stub_exti_pending &= (uint16_t)~pin;
+        HAL_GPIO_EXTI_Callback(pin);
+    }
+}
+
+void hal_stub_on_tick(void (*fn)(void))
+{
+    for (uint8_t i = 0; i < HAL_STUB_MAX_TICKS; i++) {
+        if (hal_stub_ticks[i] == fn) return;
+        if (hal_stub_ticks[i] == NULL) {
+            hal_stub_ticks[i] = fn;
+            return;
+        }
+    }
+}
+
+void hal_stub_clear_ticks(void)
+{
+    for (uint8_t i = 0; i < HAL_STUB_MAX_TICKS; i++) hal_stub_ticks[i] = NULL;
+}
+
+uint32_t HAL_GetTick(void)
+{
+    hal_stub_tick++;
+    hal_stub_irqs();
+    return hal_stub_tick;
+}
+
+void HAL_Delay(uint32_t Delay)
+{
+    uint32_t start = HAL_GetTick();
+    while (HAL_GetTick() - start < Delay) {
+    }
+}
+
+void HAL_GPIO_WritePin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin, GPIO_PinState PinState)
+{
+    if (PinState == GPIO_PIN_SET) {
+        hal_stub_levels[GPIOx->id] |= GPIO_Pin;
+    } else {
+        hal_stub_levels[GPIOx->id] &= (uint16_t)~GPIO_Pin;
+    }
+}
+
+GPIO_PinState HAL_GPIO_ReadPin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin)
+{
+    return (hal_stub_levels[GPIOx->id] & GPIO_Pin) ? GPIO_PIN_SET : GPIO_PIN_RESET;
+}
+
+GPIO_PinState hal_stub_pin(GPIO_TypeDef *port, uint16_t pin)
+{
+    return HAL_GPIO_ReadPin(port, pin);
+}
+
+void hal_stub_drive_pin(GPIO_TypeDef *port, uint16_t pin, GPIO_PinState state)
+{
+    uint8_t was = HAL_GPIO_ReadPin(port, pin) == GPIO_PIN_SET;
+    HAL_GPIO_WritePin(port, pin, state);
+    if (!was && state == GPIO_PIN_SET) hal_stub_exti_pending |= pin;
+}
+
+__weak void HAL_GPIO_EXTI_Callback(uint16_t GPIO_Pin)
+{
+    (void)GPIO_Pin;
+}
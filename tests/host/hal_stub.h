@@ -0,0 +1,19 @@
+#ifndef HAL_STUB_H
+#define HAL_STUB_H
+
+/* Test-side controls of the host HAL (hal_stub.c) */
+
+#include "stm32f1xx_hal.h"
+
+/* Called every millisecond from HAL_GetTick(), after the I2C model, while
+   interrupts are enabled. Device models register here (at most 4). */
+void hal_stub_on_tick(void (*fn)(void));
+void hal_stub_clear_ticks(void);
+
+/* Level of an output pin as last written by the firmware */
+GPIO_PinState hal_stub_pin(GPIO_TypeDef *port, uint16_t pin);
+/* Drive an input pin. A rising edge calls HAL_GPIO_EXTI_Callback at the end
+   of the current or next tick, once PRIMASK is clear. */
+void hal_stub_drive_pin(GPIO_TypeDef *port, uint16_t pin, GPIO_PinState state);
+
+#endif /* HAL_STUB_H */
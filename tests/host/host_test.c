@@ -0,0 +1,71 @@
+#include "host_test.h"
+#include "ssd1306_emu.h"
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef GOLDEN_DIR
+#error "GOLDEN_DIR must point at tests/host/golden"
+#endif
+
+unsigned host_test_failures;
+
+void host_test_fail(const char *file, int line, const char *expr, long a, long b)
+{
+    if (a != b) {
+        fprintf(stderr, "%s:%d: check failed: %s (%ld != %ld)\n", file, line, expr, a, b);
+    } else {
+        fprintf(stderr, "%s:%d: check failed: %s\n", file, line, expr);
+    }
+    host_test_failures++;
+}
+
+/* Print the panel as text, '#' for a lit pixel */
+static void print_panel(FILE *f)
+{
+    for (uint8_t y = 0; y < EMU_HEIGHT; y++) {
+        for (uint8_t x = 0; x < EMU_WIDTH; x++) fputc(emu_pixel(x, y) ? '#' : '.', f);
+        fputc('\n', f);
+    }
+}
+
+void check_golden(const char *name)
+{
+    static uint8_t image[EMU_PBM_SIZE];
+    static uint8_t golden[EMU_PBM_SIZE + 1];
+    char path[512];
+    const char *update = getenv("SSD1306_UPDATE_GOLDEN");
+
+    emu_pbm(image);
+    snprintf(path, sizeof(path), "%s/%s.pbm", GOLDEN_DIR, name);
+
+    if (update != NULL && strcmp(update, "1") == 0) {
+        FILE *f = fopen(path, "wb");
+        if (f == NULL || fwrite(image, 1, sizeof(image), f) != sizeof(image)) {
+            host_test_fail(__FILE__, __LINE__, path, 0, 0);
+        }
+        if (f != NULL) fclose(f);
+        return;
+    }
+
+    FILE *f = fopen(path, "rb");
+    size_t n = 0;
+    if (f != NULL) {
+        n = fread(golden, 1, sizeof(golden), f);
+        fclose(f);
+    }
+    if (n != sizeof(image) || memcmp(golden, image, sizeof(image)) != 0) {
+        fprintf(stderr, "golden %s differs from the panel:\n", path);
+        print_panel(stderr);
+        host_test_failures++;
+    }
+}
+
+int host_test_result(const char *name)
+{
+    if (host_test_failures != 0) {
+        fprintf(stderr, "%s: %u check(s) failed\n", name, host_test_failures);
+        return 1;
+    }
+    printf("%s: ok\n", name);
+    return 0;
+}
@@ -0,0 +1,27 @@
+#ifndef HOST_TEST_H
+#define HOST_TEST_H
+
+/* Minimal assertion helpers for the host tests. A failed check prints its
+   location and the test keeps running; host_test_result() is the exit code. */
+
+#include <stdint.h>
+#include <stdio.h>
+
+extern unsigned host_test_failures;
+
+void host_test_fail(const char *file, int line, const char *expr, long a, long b);
+
+#define CHECK(cond) \
+    do { if (!(cond)) host_test_fail(__FILE__, __LINE__, #cond, 0, 0); } while (0)
+
+#define CHECK_EQ(a, b) \
+    do { long a_ = (long)(a), b_ = (long)(b); \
+         if (a_ != b_) host_test_fail(__FILE__, __LINE__, #a " == " #b, a_, b_); } while (0)
+
+/* Compare the panel view of the SSD1306 model with golden/<name>.pbm. With
+   SSD1306_UPDATE_GOLDEN=1 in the environment the file is (re)written instead. */
+void check_golden(const char *name);
+
+int host_test_result(const char *name);
+
+#endif /* HOST_TEST_H */
@@ -0,0 +1,300 @@
+#include "ssd1306_emu.h"
+#include "stm32f1xx_hal.h"
+#include <string.h>
+
+/* 7-bit address 0x3C as passed to the HAL (shifted) */
+#define EMU_I2C_ADDR (0x3C << 1)
+
+#define EMU_MODE_HORIZONTAL 0
+#define EMU_MODE_VERTICAL   1
+#define EMU_MODE_PAGE       2
+
+/* The board's I2C handle, defined by main.c on the target */
+I2C_HandleTypeDef hi2c1;
+
+static uint8_t emu_gddram[EMU_PAGES][EMU_WIDTH];
+static uint8_t emu_mode;
+static uint8_t emu_col, emu_col0, emu_col1;
+static uint8_t emu_page, emu_page0, emu_page1;
+static uint8_t emu_line;
+static uint8_t emu_seg_remap;   /* 0xA1: column 127 on SEG0 */
+static uint8_t emu_com_remap;   /* 0xC8: COM scan from COM63 down */
+
+/* Command being assembled: opcode plus the argument bytes still expected */
+static uint8_t emu_cmd[8];
+static uint8_t emu_cmd_len;
+static uint8_t emu_cmd_need;
+
+static emu_counters_t emu_count;
+static uint32_t emu_fail;
+
+static struct {
+    uint8_t queued;
+    uint8_t control;
+    const uint8_t *buf;
+    uint16_t len;
+} emu_dma;
+static uint8_t emu_dma_on_tick;
+
+void emu_reset(void)
+{
+    uint32_t seed = 0x12345678u;
+    for (uint8_t p = 0; p < EMU_PAGES; p++) {
+        for (uint8_t c = 0; c < EMU_WIDTH; c++) {
+            seed = seed * 1664525u + 1013904223u;
+            emu_gddram[p][c] = (uint8_t)(seed >> 24);
+        }
+    }
+    emu_mode = EMU_MODE_PAGE;
+    emu_col = emu_col0 = 0;
+    emu_col1 = EMU_WIDTH - 1;
+    emu_page = emu_page0 = 0;
+    emu_page1 = EMU_PAGES - 1;
+    emu_line = 0;
+    emu_seg_remap = emu_com_remap = 0;
+    emu_cmd_len = emu_cmd_need = 0;
+    memset(&emu_count, 0, sizeof(emu_count));
+    emu_fail = 0;
+    memset(&emu_dma, 0, sizeof(emu_dma));
+    emu_dma_on_tick = 1;
+}
+
+uint8_t emu_ram(uint8_t page, uint8_t col)
+{
+    return emu_gddram[page & (EMU_PAGES - 1)][col & (EMU_WIDTH - 1)];
+}
+
+uint8_t emu_start_line(void)
+{
+    return emu_line;
+}
+
+uint8_t emu_seg_remapped(void)
+{
+    return emu_seg_remap;
+}
+
+uint8_t emu_com_remapped(void)
+{
+    return emu_com_remap;
+}
+
+uint8_t emu_pixel(uint8_t x, uint8_t y)
+{
+    /* the panel is mounted for 0xA1 / 0xC8: without them it shows mirrored */
+    uint8_t col = emu_seg_remap ? (uint8_t)(x & (EMU_WIDTH - 1)) : (uint8_t)(EMU_WIDTH - 1 - (x & (EMU_WIDTH - 1)));
+    uint8_t row = emu_com_remap ? (uint8_t)(y & (EMU_HEIGHT - 1)) : (uint8_t)(EMU_HEIGHT - 1 - (y & (EMU_HEIGHT - 1)));
+    uint8_t ry = (uint8_t)((row + emu_line) & (EMU_HEIGHT - 1));
+    return (uint8_t)((emu_gddram[ry >> 3][col] >> (ry & 7)) & 1u);
+}
+
+void emu_counters_get(emu_counters_t *c)
+{
+    *c = emu_count;
+}
+
+void emu_counters_reset(void)
+{
+    memset(&emu_count, 0, sizeof(emu_count));
+}
+
+/* Number of argument bytes that follow an opcode */
+static uint8_t emu_cmd_args(uint8_t op)
+{
+    switch (op) {
+    case 0x20: case 0x81: case 0x8D: case 0xA8: case 0xD3:
+    case 0xD5: case 0xD6: case 0xD9: case 0xDA: case 0xDB:
+        return 1;
+    case 0x21: case 0x22: case 0xA3:
+        return 2;
+    case 0x29: case 0x2A:
+        return 5;
+    case 0x26: case 0x27:
+        return 6;
+    default:
+        return 0;
+    }
+}
+
+static void emu_cmd_exec(void)
+{
+    uint8_t op = emu_cmd[0];
+
+    if (op == 0x20) {
+        emu_mode = (uint8_t)(emu_cmd[1] & 3u);
+    } else if (op == 0x21) {
+        emu_col0 = (uint8_t)(emu_cmd[1] & 0x7Fu);
+        emu_col1 = (uint8_t)(emu_cmd[2] & 0x7Fu);
+        emu_col = emu_col0;
+    } else if (op == 0x22) {
+        emu_page0 = (uint8_t)(emu_cmd[1] & 7u);
+        emu_page1 = (uint8_t)(emu_cmd[2] & 7u);
+        emu_page = emu_page0;
+    } else if (op >= 0xB0 && op <= 0xB7) {
+        emu_page = (uint8_t)(op & 7u);
+    } else if (op <= 0x0F) {
+        emu_col = (uint8_t)((emu_col & 0xF0u) | op);
+    } else if (op <= 0x1F) {
+        emu_col = (uint8_t)((emu_col & 0x0Fu) | ((op & 0x07u) << 4));
+    } else if (op >= 0x40 && op <= 0x7F) {
+        emu_line = (uint8_t)(op & 0x3Fu);
+        emu_count.start_line_seq = emu_count.transactions;
+    } else if (op == 0xA0 || op == 0xA1) {
+        emu_seg_remap = (uint8_t)(op & 1u);
+    } else if (op == 0xC0 || op == 0xC8) {
+        emu_com_remap = (uint8_t)((op >> 3) & 1u);
+    }
+    /* contrast, inversion, charge pump, ... are not modelled */
+}
+
+static void emu_command_byte(uint8_t b)
+{
+    if (emu_cmd_need == 0) {
+        emu_cmd[0] = b;
+        emu_cmd_len = 1;
+        emu_cmd_need = emu_cmd_args(b);
+    } else {
+        emu_cmd[emu_cmd_len++] = b;
+        emu_cmd_need--;
+    }
+    if (emu_cmd_need == 0) emu_cmd_exec();
+}
+
+static void emu_data_byte(uint8_t b)
+{
+    emu_gddram[emu_page][emu_col] = b;
+    emu_count.data_bytes++;
+
+    switch (emu_mode) {
+    case EMU_MODE_HORIZONTAL:
+        if (emu_col >= emu_col1) {
+            emu_col = emu_col0;
+            emu_page = (emu_page >= emu_page1) ? emu_page0 : (uint8_t)(emu_page + 1);
+        } else {
+            emu_col++;
+        }
+        break;
+    case EMU_MODE_VERTICAL:
+        if (emu_page >= emu_page1) {
+            emu_page = emu_page0;
+            emu_col = (emu_col >= emu_col1) ? emu_col0 : (uint8_t)(emu_col + 1);
+        } else {
+            emu_page++;
+        }
+        break;
+    default:
+        emu_col = (uint8_t)((emu_col + 1) & (EMU_WIDTH - 1));
+        break;
+    }
+}
+
+/* One transaction: address, control byte, then the stream */
+static HAL_StatusTypeDef emu_transfer(uint16_t addr, uint16_t control, const uint8_t *buf, uint16_t len)
+{
+    if (addr != EMU_I2C_ADDR) {
+        emu_count.protocol_errors++;
+        return HAL_ERROR;
+    }
+    if (emu_fail > 0) {
+        emu_fail--;
+        emu_count.failed++;
+        return HAL_ERROR;
+    }
+
+    emu_count.transactions++;
+    emu_count.payload_bytes += 1u + len;
+
+    if (control == 0x00) {
+        for (uint16_t i = 0; i < len; i++) emu_command_byte(buf[i]);
+        if (emu_cmd_need != 0) {
+            /* the driver never splits a command from its arguments */
+            emu_count.protocol_errors++;
+            emu_cmd_need = 0;
+        }
+    } else if (control == 0x40) {
+        for (uint16_t i = 0; i < len; i++) emu_data_byte(buf[i]);
+        emu_count.last_data_seq = emu_count.transactions;
+    } else {
+        /* Co = 1 or a stray D/C# pattern: not used by this driver */
+        emu_count.protocol_errors++;
+    }
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_I2C_Mem_Write(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint16_t MemAddress,
+                                    uint16_t MemAddSize, uint8_t *pData, uint16_t Size, uint32_t Timeout)
+{
+    (void)Timeout;
+    if (hi2c != &hi2c1 || MemAddSize != I2C_MEMADD_SIZE_8BIT) {
+        emu_count.protocol_errors++;
+        return HAL_ERROR;
+    }
+    if (emu_dma.queued) return HAL_BUSY;
+    return emu_transfer(DevAddress, MemAddress, pData, Size);
+}
+
+HAL_StatusTypeDef HAL_I2C_Mem_Write_DMA(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint16_t MemAddress,
+                                        uint16_t MemAddSize, uint8_t *pData, uint16_t Size)
+{
+    if (hi2c != &hi2c1 || MemAddSize != I2C_MEMADD_SIZE_8BIT || DevAddress != EMU_I2C_ADDR) {
+        emu_count.protocol_errors++;
+        return HAL_ERROR;
+    }
+    if (emu_dma.queued) return HAL_BUSY;
+    emu_dma.queued = 1;
+    emu_dma.control = (uint8_t)MemAddress;
+    emu_dma.buf = pData;
+    emu_dma.len = Size;
+    return HAL_OK;
+}
+
+void emu_dma_auto(uint8_t on)
+{
+    emu_dma_on_tick = on;
+}
+
+uint8_t emu_dma_pending(void)
+{
+    return emu_dma.queued;
+}
+
+void emu_dma_complete(void)
+{
+    if (!emu_dma.queued) return;
+    emu_dma.queued = 0;
+    /* the callback may queue the next transfer */
+    if (emu_transfer(EMU_I2C_ADDR, emu_dma.control, emu_dma.buf, emu_dma.len) == HAL_OK) {
+        HAL_I2C_MemTxCpltCallback(&hi2c1);
+    } else {
+        hi2c1.ErrorCode = HAL_I2C_ERROR_AF;
+        HAL_I2C_ErrorCallback(&hi2c1);
+    }
+}
+
+void emu_fail_next(uint32_t n)
+{
+    emu_fail = n;
+}
+
+void emu_tick(void)
+{
+    if (emu_dma_on_tick) emu_dma_complete();
+}
+
+void emu_pbm(uint8_t *out)
+{
+    static const char header[] = "P4\n128 64\n";
+    memcpy(out, header, sizeof(header) - 1);
+    out += sizeof(header) - 1;
+    for (uint8_t y = 0; y < EMU_HEIGHT; y++) {
+        for (uint8_t i = 0; i < EMU_WIDTH / 8; i++) {
+            uint8_t b = 0;
+            for (uint8_t k = 0; k < 8; k++) b = (uint8_t)((b << 1) | emu_pixel((uint8_t)(i * 8 + k), y));
+            *out++ = b;
+        }
+    }
+}
+
+/* Weak defaults so tests without a DMA-capable driver still link */
+__weak void HAL_I2C_MemTxCpltCallback(I2C_HandleTypeDef *hi2c) { (void)hi2c; }
+__weak void HAL_I2C_ErrorCallback(I2C_HandleTypeDef *hi2c) { (void)hi2c; }
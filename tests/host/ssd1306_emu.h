@@ -0,0 +1,76 @@
+#ifndef SSD1306_EMU_H
+#define SSD1306_EMU_H
+
+/* Host model of an SSD1306 panel behind the HAL I2C stub.
+
+   HAL_I2C_Mem_Write / HAL_I2C_Mem_Write_DMA are decoded the way the
+   controller does: the memory address byte is the control byte (0x00 =
+   command stream, 0x40 = data stream), commands update the addressing state
+   (0x20 mode, 0x21 column window, 0x22 page window, 0xB0..0xB7 / 0x00..0x1F
+   page-mode cursor, 0x40|n start line, 0xA0/0xA1 segment remap, 0xC0/0xC8
+   COM scan direction) and data bytes land in a 128 x 64 GDDRAM model.
+
+   The panel view is GDDRAM rotated by the start line. The modelled module is
+   mounted for 0xA1 + 0xC8 (what ssd1306_init() sends): column 0 / row 0 are
+   top left. Without 0xA1 the view is mirrored left to right, without 0xC8
+   top to bottom, as at power-on. The remap is applied when the panel is
+   read, which matches the controller as long as it is set before any data
+   (the controller applies 0xA0/0xA1 to data written afterwards only).
+
+   A DMA transfer is only queued by HAL_I2C_Mem_Write_DMA. It is applied and
+   completed (HAL_I2C_MemTxCpltCallback) by emu_dma_complete(), or by the next
+   HAL tick while auto completion is on (the default), so the driver sees the
+   same completion-in-interrupt ordering as on the target. */
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define EMU_WIDTH  128
+#define EMU_PAGES  8
+#define EMU_HEIGHT (EMU_PAGES * 8)
+
+/* Size of a P4 image of the panel: "P4\n128 64\n" + 64 rows of 16 bytes */
+#define EMU_PBM_SIZE (10 + EMU_HEIGHT * EMU_WIDTH / 8)
+
+typedef struct {
+    uint32_t transactions;    /* I2C transactions addressed to the panel */
+    uint32_t payload_bytes;   /* control byte + command / data bytes */
+    uint32_t data_bytes;      /* bytes written to GDDRAM */
+    uint32_t failed;          /* transactions rejected by emu_fail_next() */
+    uint32_t protocol_errors; /* bad address, control byte or truncated command */
+    uint32_t last_data_seq;   /* transaction number of the last data stream */
+    uint32_t start_line_seq;  /* transaction number of the last 0x40|n command */
+} emu_counters_t;
+
+/* Power-on state: GDDRAM filled with noise, page addressing at 0/0, start
+   line 0, no remap (0xA0, 0xC0), no pending transfer, counters cleared,
+   auto completion on */
+void emu_reset(void);
+
+uint8_t emu_ram(uint8_t page, uint8_t col);
+uint8_t emu_start_line(void);
+uint8_t emu_seg_remapped(void);   /* 1 after 0xA1 */
+uint8_t emu_com_remapped(void);   /* 1 after 0xC8 */
+/* Pixel as shown on the panel (start line and remap applied) */
+uint8_t emu_pixel(uint8_t x, uint8_t y);
+
+void emu_counters_get(emu_counters_t *c);
+void emu_counters_reset(void);
+
+/* DMA: 1 = a queued transfer completes on the next HAL tick */
+void emu_dma_auto(uint8_t on);
+uint8_t emu_dma_pending(void);
+/* Complete the queued transfer (or fail it, see emu_fail_next) */
+void emu_dma_complete(void);
+
+/* The next n transactions are NACKed: nothing reaches GDDRAM, a blocking
+   write returns HAL_ERROR and a DMA transfer ends in HAL_I2C_ErrorCallback */
+void emu_fail_next(uint32_t n);
+
+/* P4 image of the panel view; out must hold EMU_PBM_SIZE bytes */
+void emu_pbm(uint8_t *out);
+
+/* Called by hal_stub.c on every tick */
+void emu_tick(void);
+
+#endif /* SSD1306_EMU_H */
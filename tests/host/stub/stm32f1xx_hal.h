@@ -0,0 +1,155 @@
+#ifndef STM32F1XX_HAL_H
+#define STM32F1XX_HAL_H
+
+/* Host stand-in for the STM32F1 HAL: the types, constants and functions the
+   user modules in Core/Src use, nothing more. The functions are implemented
+   by hal_stub.c and the device models behind it (ssd1306_emu.c). */
+
+#include <stdint.h>
+#include <stddef.h>
+
+typedef enum {
+    HAL_OK = 0x00U,
+    HAL_ERROR = 0x01U,
+    HAL_BUSY = 0x02U,
+    HAL_TIMEOUT = 0x03U
+} HAL_StatusTypeDef;
+
+#define HAL_MAX_DELAY 0xFFFFFFFFU
+#define __weak __attribute__((weak))
+#define __IO volatile
+
+/* Interrupt masking: the host runs device "interrupts" only from inside HAL
+   calls (see hal_stub.c). With PRIMASK set they are held back until the
+   next HAL call after it is cleared. */
+extern uint32_t hal_stub_primask;
+static inline void __disable_irq(void) { hal_stub_primask = 1; }
+static inline void __enable_irq(void) { hal_stub_primask = 0; }
+static inline uint32_t __get_PRIMASK(void) { return hal_stub_primask; }
+static inline void __set_PRIMASK(uint32_t primask) { hal_stub_primask = primask; }
+static inline void __DMB(void) { __sync_synchronize(); }
+static inline void __NOP(void) { }
+
+uint32_t HAL_GetTick(void);
+void HAL_Delay(uint32_t Delay);
+
+/* --- GPIO ---------------------------------------------------------------- */
+typedef struct { uint32_t id; } GPIO_TypeDef;
+extern GPIO_TypeDef *const GPIOA;
+extern GPIO_TypeDef *const GPIOB;
+extern GPIO_TypeDef *const GPIOC;
+
+typedef enum { GPIO_PIN_RESET = 0, GPIO_PIN_SET } GPIO_PinState;
+
+#define GPIO_PIN_12 ((uint16_t)0x1000)
+#define GPIO_PIN_13 ((uint16_t)0x2000)
+#define GPIO_PIN_14 ((uint16_t)0x4000)
+
+void HAL_GPIO_WritePin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin, GPIO_PinState PinState);
+GPIO_PinState HAL_GPIO_ReadPin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin);
+void HAL_GPIO_EXTI_Callback(uint16_t GPIO_Pin);
+
+/* --- RCC ----------------------------------------------------------------- */
+uint32_t HAL_RCC_GetPCLK1Freq(void);
+
+/* --- DMA ----------------------------------------------------------------- */
+typedef struct {
+    volatile uint32_t CNDTR;  /* transfers left */
+} DMA_Channel_TypeDef;
+
+typedef struct {
+    DMA_Channel_TypeDef *Instance;
+} DMA_HandleTypeDef;
+
+#define __HAL_DMA_GET_COUNTER(__HANDLE__) ((__HANDLE__)->Instance->CNDTR)
+
+#define DMA_IT_HT 0x00000004U
+#define __HAL_DMA_DISABLE_IT(__HANDLE__, __INTERRUPT__) ((void)(__HANDLE__), (void)(__INTERRUPT__))
+
+/* --- UART ---------------------------------------------------------------- */
+typedef struct {
+    volatile uint32_t SR;
+    volatile uint32_t DR;
+    volatile uint32_t BRR;
+    volatile uint32_t CR1;
+} USART_TypeDef;
+extern USART_TypeDef *const USART2;
+
+#define UART_FLAG_TC 0x00000040U
+#define __HAL_UART_GET_FLAG(__HANDLE__, __FLAG__) ((((__HANDLE__)->Instance->SR) & (__FLAG__)) == (__FLAG__))
+#define UART_BRR_SAMPLING16(_PCLK_, _BAUD_) (((_PCLK_) + ((_BAUD_) / 2U)) / (_BAUD_))
+
+#define USART_CR1_UE  0x00002000U
+#define USART_CR1_M   0x00001000U
+#define USART_CR1_PCE 0x00000400U
+#define USART_CR1_PS  0x00000200U
+
+/* Same values as the CR1 bits they select, as in the real HAL */
+#define UART_WORDLENGTH_8B 0x00000000U
+#define UART_WORDLENGTH_9B USART_CR1_M
+#define UART_PARITY_NONE   0x00000000U
+#define UART_PARITY_EVEN   USART_CR1_PCE
+#define UART_PARITY_ODD    (USART_CR1_PCE | USART_CR1_PS)
+
+typedef struct {
+    uint32_t BaudRate;
+    uint32_t WordLength;
+    uint32_t Parity;
+} UART_InitTypeDef;
+
+typedef enum {
+    HAL_UART_STATE_RESET = 0x00U,
+    HAL_UART_STATE_READY = 0x20U,
+    HAL_UART_STATE_BUSY_TX = 0x21U,
+    HAL_UART_STATE_BUSY_RX = 0x22U
+} HAL_UART_StateTypeDef;
+
+#define HAL_UART_ERROR_NONE 0x00000000U
+#define HAL_UART_ERROR_PE   0x00000001U
+#define HAL_UART_ERROR_NE   0x00000002U
+#define HAL_UART_ERROR_FE   0x00000004U
+#define HAL_UART_ERROR_ORE  0x00000008U
+#define HAL_UART_ERROR_DMA  0x00000010U
+
+typedef uint32_t HAL_UART_RxEventTypeTypeDef;
+#define HAL_UART_RXEVENT_TC   0x00000000U
+#define HAL_UART_RXEVENT_HT   0x00000001U
+#define HAL_UART_RXEVENT_IDLE 0x00000002U
+
+typedef struct {
+    USART_TypeDef *Instance;
+    UART_InitTypeDef Init;
+    DMA_HandleTypeDef *hdmatx;
+    DMA_HandleTypeDef *hdmarx;
+    volatile HAL_UART_StateTypeDef gState;
+    volatile HAL_UART_StateTypeDef RxState;
+    volatile uint32_t ErrorCode;
+} UART_HandleTypeDef;
+
+HAL_StatusTypeDef HAL_UART_Transmit_DMA(UART_HandleTypeDef *huart, const uint8_t *pData, uint16_t Size);
+HAL_StatusTypeDef HAL_UARTEx_ReceiveToIdle_IT(UART_HandleTypeDef *huart, uint8_t *pData, uint16_t Size);
+HAL_StatusTypeDef HAL_UARTEx_ReceiveToIdle_DMA(UART_HandleTypeDef *huart, uint8_t *pData, uint16_t Size);
+HAL_UART_RxEventTypeTypeDef HAL_UARTEx_GetRxEventType(UART_HandleTypeDef *huart);
+void HAL_UART_TxCpltCallback(UART_HandleTypeDef *huart);
+void HAL_UARTEx_RxEventCallback(UART_HandleTypeDef *huart, uint16_t Size);
+void HAL_UART_ErrorCallback(UART_HandleTypeDef *huart);
+
+/* --- I2C ----------------------------------------------------------------- */
+typedef struct { uint32_t id; } I2C_TypeDef;
+
+typedef struct {
+    I2C_TypeDef *Instance;
+    volatile uint32_t ErrorCode;
+} I2C_HandleTypeDef;
+
+#define I2C_MEMADD_SIZE_8BIT 0x00000001U
+#define HAL_I2C_ERROR_AF     0x00000004U
+
+HAL_StatusTypeDef HAL_I2C_Mem_Write(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint16_t MemAddress,
+                                    uint16_t MemAddSize, uint8_t *pData, uint16_t Size, uint32_t Timeout);
+HAL_StatusTypeDef HAL_I2C_Mem_Write_DMA(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint16_t MemAddress,
+                                        uint16_t MemAddSize, uint8_t *pData, uint16_t Size);
+void HAL_I2C_MemTxCpltCallback(I2C_HandleTypeDef *hi2c);
+void HAL_I2C_ErrorCallback(I2C_HandleTypeDef *hi2c);
+
+#endif /* STM32F1XX_HAL_H */
@@ -0,0 +1,45 @@
+/* display_queue: a new screen (clear + text) is one request, queued or
+   dropped as a whole */
+
+#include "host_test.h"
+#include "display_queue.h"
+#include "ssd1306_emu.h"
+
+/* Any lit pixel in page rows page0..page1 of the framebuffer */
+static int fb_inked(uint8_t page0, uint8_t page1)
+{
+    const uint8_t *fb = ssd1306_framebuffer();
+    for (uint16_t i = page0 * SSD1306_WIDTH; i < (page1 + 1) * SSD1306_WIDTH; i++) {
+        if (fb[i] != 0) return 1;
+    }
+    return 0;
+}
+
+int main(void)
+{
+    emu_reset();
+    ssd1306_init();
+    ssd1306_clear();
+
+    /* old screen content */
+    ssd1306_write_string(0, 6, "old screen");
+    CHECK(fb_inked(6, 6));
+
+    /* fill all but one slot, then a new screen still fits */
+    for (uint8_t i = 0; i < DISPLAY_QUEUE_SIZE - 1; i++) {
+        CHECK(display_queue_post_text(&ssd1306_font_5x8, 0, 0, "x"));
+    }
+    CHECK(display_queue_post_screen(&ssd1306_font_5x8, 0, 16, "new screen"));
+    /* full: the next screen is dropped whole, not as a clear without text */
+    CHECK(!display_queue_post_screen(&ssd1306_font_5x8, 0, 32, "dropped"));
+    CHECK_EQ(display_queue_dropped(), 1);
+
+    display_queue_drain();
+    CHECK(!fb_inked(0, 1));
+    CHECK(fb_inked(2, 2));
+    CHECK(!fb_inked(3, 7));
+
+    CHECK(ssd1306_flush() == HAL_OK);
+    check_golden("queue_screen");
+    return host_test_result("display_queue");
+}
@@ -0,0 +1,186 @@
+/* e32: module configuration in program mode against the module model —
+   read, save (C0), temporary write (C2), parity, a bad reply, echoes that
+   come after AUX rose and a slow mode switch */
+
+#include "host_test.h"
+#include "e32.h"
+#include "e32_sim.h"
+#include "hal_stub.h"
+#include "stackmon.h"
+#include <string.h>
+
+void stackmon_report(void (*out)(const char *line))
+{
+    out("stack n/a\n");
+}
+
+static void start(void)
+{
+    e32_sim_reset();
+    E32_StartReceive();
+    HAL_Delay(2);
+}
+
+/* Back in normal mode at the module's baud rate: data goes on the air */
+static void check_link(void)
+{
+    static const uint8_t data[] = "link";
+
+    CHECK_EQ(hal_stub_pin(E32_M0_PORT, E32_M0_PIN), GPIO_PIN_RESET);
+    CHECK_EQ(hal_stub_pin(E32_M1_PORT, E32_M1_PIN), GPIO_PIN_RESET);
+    e32_sim.air_len = 0;
+    E32_Write(data, 4);
+    HAL_Delay(100);
+    CHECK_EQ(e32_sim.air_len, 4);
+    CHECK(memcmp(e32_sim.air, data, 4) == 0);
+}
+
+static void test_read(void)
+{
+    E32_Config cfg;
+
+    start();
+    CHECK(E32_ReadConfig(&cfg) == HAL_OK);
+    CHECK_EQ(cfg.uart_baud, 9600);
+    CHECK_EQ(cfg.air_rate, E32_AIR_2400);
+    CHECK_EQ(cfg.parity, E32_PARITY_8N1);
+    CHECK_EQ(cfg.channel, 0x17);
+    CHECK_EQ(cfg.io_push_pull, 1);
+    CHECK_EQ(e32_sim.commands, 1);
+    CHECK_EQ(e32_sim.garbled, 0);
+    check_link();
+}
+
+static void test_save(void)
+{
+    static const uint8_t expect[6] = { 0xC0, 0x00, 0x00, 0x3A, 0x17, 0x44 };
+    E32_Config cfg;
+
+    start();
+    CHECK(E32_ReadConfig(&cfg) == HAL_OK);
+    cfg.uart_baud = 115200;
+    CHECK(E32_WriteConfig(&cfg, 1) == HAL_OK);
+    CHECK(memcmp(e32_sim.params, expect, 6) == 0);
+    CHECK(memcmp(e32_sim.saved, expect, 6) == 0);
+    CHECK_EQ(huart2.Init.BaudRate, 115200);
+    CHECK_EQ(e32_sim.garbled, 0);
+    check_link();
+}
+
+/* C2 is not saved; its echo starts with C2, so taking it for the C1 reply
+   would fail the write */
+static void test_temporary(void)
+{
+    static const uint8_t factory[6] = { 0xC0, 0x00, 0x00, 0x1A, 0x17, 0x44 };
+    E32_Config cfg;
+
+    start();
+    e32_sim.echo_late_ms = 20;
+    CHECK(E32_ReadConfig(&cfg) == HAL_OK);
+    cfg.channel = 0x05;
+    CHECK(E32_WriteConfig(&cfg, 0) == HAL_OK);
+    CHECK_EQ(e32_sim.params[4], 0x05);
+    CHECK(memcmp(e32_sim.saved, factory, 6) == 0);
+    CHECK(E32_ReadConfig(&cfg) == HAL_OK);
+    CHECK_EQ(cfg.channel, 0x05);
+    check_link();
+}
+
+/* A parity other than 8N1 reframes USART2 (9 bits with the parity bit),
+   both after a write and after reading a module that already uses it */
+static void test_parity(void)
+{
+    E32_Config cfg;
+
+    start();
+    CHECK(E32_ReadConfig(&cfg) == HAL_OK);
+    cfg.parity = E32_PARITY_8E1;
+    CHECK(E32_WriteConfig(&cfg, 1) == HAL_OK);
+    CHECK_EQ(e32_sim.saved[3] >> 6, 2);
+    CHECK_EQ(huart2.Init.Parity, UART_PARITY_EVEN);
+    CHECK_EQ(huart2.Init.WordLength, UART_WORDLENGTH_9B);
+    CHECK_EQ(USART2->CR1 & (USART_CR1_M | USART_CR1_PCE | USART_CR1_PS), USART_CR1_M | USART_CR1_PCE);
+    CHECK_EQ(e32_sim.garbled, 0);
+    check_link();
+
+    /* program mode is always 8N1: reading goes back there and returns */
+    CHECK(E32_ReadConfig(&cfg) == HAL_OK);
+    CHECK_EQ(cfg.parity, E32_PARITY_8E1);
+    CHECK_EQ(e32_sim.garbled, 0);
+    check_link();
+
+    cfg.parity = E32_PARITY_8N1;
+    CHECK(E32_WriteConfig(&cfg, 1) == HAL_OK);
+    CHECK_EQ(huart2.Init.Parity, UART_PARITY_NONE);
+    CHECK_EQ(USART2->CR1 & (USART_CR1_M | USART_CR1_PCE | USART_CR1_PS), 0);
+    check_link();
+
+    /* a module already set to 8O1 at 19200 */
+    start();
+    e32_sim.params[3] = 0x62;
+    CHECK(E32_ReadConfig(&cfg) == HAL_OK);
+    CHECK_EQ(cfg.parity, E32_PARITY_8O1);
+    CHECK_EQ(huart2.Init.BaudRate, 19200);
+    CHECK_EQ(huart2.Init.Parity, UART_PARITY_ODD);
+    check_link();
+}
+
+/* A module without the echo still writes, only slower */
+static void test_no_echo(void)
+{
+    E32_Config cfg;
+
+    start();
+    e32_sim.echo = 0;
+    CHECK(E32_ReadConfig(&cfg) == HAL_OK);
+    cfg.air_rate = E32_AIR_4800;
+    CHECK(E32_WriteConfig(&cfg, 1) == HAL_OK);
+    CHECK_EQ(e32_sim.saved[3] & 0x07, E32_AIR_4800);
+    check_link();
+}
+
+/* A reply that is not C0 + parameters: error, UART left at its speed */
+static void test_bad_reply(void)
+{
+    E32_Config cfg;
+
+    start();
+    e32_sim.bad_reply = 1;
+    CHECK(E32_ReadConfig(&cfg) == HAL_ERROR);
+    CHECK_EQ(huart2.Init.BaudRate, 9600);
+    check_link();
+
+    e32_sim.bad_reply = 0;
+    CHECK(E32_ReadConfig(&cfg) == HAL_OK);
+    cfg.channel = 0x01;
+    e32_sim.bad_reply = 1;
+    CHECK(E32_WriteConfig(&cfg, 1) == HAL_ERROR);
+    check_link();
+}
+
+/* AUX falls only after the old fixed 50 ms delay: the command must still
+   wait for the module to enter program mode */
+static void test_slow_switch(void)
+{
+    E32_Config cfg;
+
+    start();
+    e32_sim.aux_lag_ms = 60;
+    CHECK(E32_ReadConfig(&cfg) == HAL_OK);
+    CHECK_EQ(cfg.channel, 0x17);
+    CHECK_EQ(e32_sim.air_len, 0);
+    CHECK_EQ(e32_sim.garbled, 0);
+    check_link();
+}
+
+int main(void)
+{
+    test_read();
+    test_save();
+    test_temporary();
+    test_parity();
+    test_no_echo();
+    test_bad_reply();
+    test_slow_switch();
+    return host_test_result("e32_config");
+}
@@ -0,0 +1,252 @@
+/* e32: the TX queue drains through DMA errors and refused DMA starts, the
+   RX ring keeps packets whole across the 64-byte reception buffer, frames
+   are found in received packets, text lines run across packets, "#log"
+   reports the message history */
+
+#include "host_test.h"
+#include "e32.h"
+#include "e32_sim.h"
+#include "display_queue.h"
+#include "frame.h"
+#include "msglog.h"
+#include "stackmon.h"
+#include <string.h>
+
+void stackmon_report(void (*out)(const char *line))
+{
+    out("stack n/a\n");
+}
+
+static void run_ms(uint32_t ms)
+{
+    HAL_Delay(ms);
+}
+
+/* Let the queue drain, E32_Poll() being the only thing called */
+static void poll_until_sent(uint32_t limit_ms)
+{
+    uint32_t start = HAL_GetTick();
+    while (E32_TxPending() > 0 && HAL_GetTick() - start < limit_ms) E32_Poll();
+}
+
+static void fill(uint8_t *buf, uint16_t len, uint8_t seed)
+{
+    for (uint16_t i = 0; i < len; i++) buf[i] = (uint8_t)(seed + i * 7);
+}
+
+static void test_chunks(void)
+{
+    uint8_t data[150];
+
+    e32_sim_reset();
+    fill(data, sizeof(data), 1);
+    CHECK_EQ(E32_Write(data, sizeof(data)), sizeof(data));
+    run_ms(1000);
+    CHECK_EQ(E32_TxPending(), 0);
+    CHECK_EQ(e32_sim.air_len, sizeof(data));
+    CHECK(memcmp(e32_sim.air, data, sizeof(data)) == 0);
+    CHECK_EQ(e32_sim.air_chunks, 3);
+    CHECK_EQ(e32_sim.max_chunk, E32_TX_CHUNK);
+    CHECK_EQ(e32_sim.garbled, 0);
+}
+
+/* A DMA error ends the transfer: what CNDTR says was not sent goes again */
+static void test_dma_error(void)
+{
+    uint8_t data[100];
+    uint32_t errors = E32_TxErrors();
+
+    e32_sim_reset();
+    fill(data, sizeof(data), 2);
+    e32_sim.tx_fail = 1;
+    E32_Write(data, sizeof(data));
+    run_ms(1000);
+    CHECK_EQ(E32_TxPending(), 0);
+    CHECK_EQ(E32_TxErrors() - errors, 1);
+    CHECK_EQ(e32_sim.air_len, sizeof(data));
+    CHECK(memcmp(e32_sim.air, data, sizeof(data)) == 0);
+
+    /* an error on the second chunk, after the first went through */
+    e32_sim_reset();
+    E32_Write(data, sizeof(data));
+    run_ms(70);
+    CHECK_EQ(e32_sim.air_chunks, 1);
+    e32_sim.tx_fail = 1;
+    run_ms(1000);
+    CHECK_EQ(E32_TxPending(), 0);
+    CHECK_EQ(E32_TxErrors() - errors, 2);
+    CHECK_EQ(e32_sim.air_len, sizeof(data));
+    CHECK(memcmp(e32_sim.air, data, sizeof(data)) == 0);
+
+    /* 20 bytes of the chunk were shifted out before the error: they are not
+       sent twice */
+    e32_sim_reset();
+    e32_sim.tx_fail = 1;
+    e32_sim.tx_fail_sent = 20;
+    E32_Write(data, sizeof(data));
+    run_ms(1000);
+    CHECK_EQ(E32_TxPending(), 0);
+    CHECK_EQ(E32_TxErrors() - errors, 3);
+    CHECK_EQ(e32_sim.air_len, sizeof(data));
+    CHECK(memcmp(e32_sim.air, data, sizeof(data)) == 0);
+    CHECK_EQ(e32_sim.garbled, 0);
+}
+
+/* HAL refused the DMA start: no completion or AUX edge will come, the main
+   loop retries */
+static void test_refused_start(void)
+{
+    uint8_t data[10];
+
+    e32_sim_reset();
+    run_ms(2);
+    fill(data, sizeof(data), 3);
+    e32_sim.tx_refuse = 1;
+    E32_Write(data, sizeof(data));
+    CHECK_EQ(e32_sim.tx_refuse, 0);
+    CHECK_EQ(E32_TxPending(), sizeof(data));
+    poll_until_sent(100);
+    CHECK_EQ(E32_TxPending(), 0);
+    CHECK_EQ(e32_sim.air_len, sizeof(data));
+    CHECK(memcmp(e32_sim.air, data, sizeof(data)) == 0);
+}
+
+/* Receive errors: an overrun stops the reception, which is restarted; noise
+   is only counted */
+static void test_rx(void)
+{
+    uint8_t data[100];
+    uint8_t buf[E32_RX_RING_SIZE];
+    uint32_t overruns = E32_RxOverruns();
+    uint32_t truncated = E32_RxTruncated();
+
+    e32_sim_reset();
+    E32_StartReceive();
+    fill(data, sizeof(data), 4);
+    e32_sim_receive(data, sizeof(data));
+    run_ms(2);
+    CHECK_EQ(E32_ReadPacket(buf, sizeof(buf)), sizeof(data));
+    CHECK(memcmp(buf, data, sizeof(data)) == 0);
+
+    e32_sim_receive(data, sizeof(data));
+    run_ms(2);
+    CHECK_EQ(E32_ReadPacket(buf, 40), 40);
+    CHECK_EQ(E32_RxTruncated() - truncated, 1);
+    CHECK_EQ(E32_ReadPacket(buf, sizeof(buf)), 0);
+
+    e32_sim_rx_error(HAL_UART_ERROR_NE);
+    CHECK_EQ(E32_RxOverruns() - overruns, 1);
+    e32_sim_rx_error(HAL_UART_ERROR_ORE);
+    CHECK_EQ(E32_RxOverruns() - overruns, 2);
+    e32_sim_receive(data, 20);
+    run_ms(2);
+    CHECK_EQ(E32_ReadPacket(buf, sizeof(buf)), 20);
+    CHECK_EQ(e32_sim.rx_lost, 0);
+
+    /* an RX error while a chunk is in flight leaves the transfer alone */
+    uint32_t errors = E32_TxErrors();
+    e32_sim.air_len = 0;
+    E32_Write(data, 30);
+    e32_sim_rx_error(HAL_UART_ERROR_FE);
+    run_ms(200);
+    CHECK_EQ(E32_TxErrors(), errors);
+    CHECK_EQ(e32_sim.air_len, 30);
+}
+
+static uint8_t frames_seen;
+static uint8_t frame_last_len;
+
+static void on_frame(uint8_t type, const uint8_t *payload, uint8_t len)
+{
+    frames_seen++;
+    frame_last_len = len;
+}
+
+/* A stray SYNC in front of a frame costs errors, not the frame; a broken
+   frame does not leak into the next packet */
+static void test_frames(void)
+{
+    uint8_t payload[FRAME_MAX_PAYLOAD];
+    uint8_t pkt[4 + FRAME_MAX_SIZE] = { 0xA5, 0xA5, 0x00, 0x11 };
+    uint32_t errors = E32_FrameErrors();
+
+    e32_sim_reset();
+    E32_StartReceive();
+    E32_SetFrameHandler(on_frame);
+    fill(payload, sizeof(payload), 5);
+    CHECK_EQ(frame_encode(0x10, payload, sizeof(payload), &pkt[4], FRAME_MAX_SIZE), FRAME_MAX_SIZE);
+
+    e32_sim_receive(pkt, sizeof(pkt));
+    run_ms(2);
+    E32_Poll();
+    CHECK_EQ(frames_seen, 1);
+    CHECK_EQ(frame_last_len, FRAME_MAX_PAYLOAD);
+    CHECK_EQ(E32_FrameErrors() - errors, 2);
+
+    /* first half of a frame, then a whole one */
+    e32_sim_receive(&pkt[4], 20);
+    run_ms(2);
+    e32_sim_receive(&pkt[4], FRAME_MAX_SIZE);
+    run_ms(2);
+    E32_Poll();
+    CHECK_EQ(frames_seen, 2);
+    E32_SetFrameHandler(NULL);
+}
+
+/* A text line is joined across packets until '\n' or a full rx_line */
+static void test_text_lines(void)
+{
+    static const char *const packets[] = { "hello ", "world\r\nnext", " line\n" };
+    char longer[RX_LINE_MAX + 8];
+
+    e32_sim_reset();
+    E32_StartReceive();
+    for (uint8_t i = 0; i < 3; i++) {
+        e32_sim_receive((const uint8_t *)packets[i], (uint16_t)strlen(packets[i]));
+        run_ms(2);
+        E32_Poll();
+    }
+    display_queue_drain();
+    CHECK(strcmp(msglog_get(1)->text, "hello world") == 0);
+    CHECK(strcmp(msglog_get(0)->text, "next line") == 0);
+
+    /* no '\n': a full buffer ends the line, the rest starts the next one */
+    memset(longer, 'a', sizeof(longer));
+    longer[RX_LINE_MAX - 1] = 'b';
+    e32_sim_receive((const uint8_t *)longer, sizeof(longer));
+    run_ms(2);
+    E32_Poll();
+    e32_sim_receive((const uint8_t *)"\n", 1);
+    run_ms(2);
+    E32_Poll();
+    display_queue_drain();
+    CHECK_EQ(strlen(msglog_get(1)->text), RX_LINE_MAX - 1);
+    CHECK_EQ(strlen(msglog_get(0)->text), sizeof(longer) - (RX_LINE_MAX - 1));
+    CHECK_EQ(msglog_get(0)->text[0], 'b');
+}
+
+/* "#log" sends the message history back over the radio */
+static void test_log_report(void)
+{
+    e32_sim_reset();
+    E32_StartReceive();
+    msglog_add("hello");
+    e32_sim_receive((const uint8_t *)"#log", 4);
+    run_ms(2);
+    E32_Poll();
+    run_ms(200);
+    CHECK(e32_sim.air_len >= 12);
+    CHECK(memcmp(&e32_sim.air[e32_sim.air_len - 6], "hello\n", 6) == 0);
+}
+
+int main(void)
+{
+    test_chunks();
+    test_dma_error();
+    test_refused_start();
+    test_rx();
+    test_frames();
+    test_text_lines();
+    test_log_report();
+    return host_test_result("e32_link");
+}
@@ -0,0 +1,104 @@
+/* fixfmt: signs just below zero, rounding that carries into the degree, the
+   int32 / uint32 extremes and buffers that are too small */
+
+#include "host_test.h"
+#include "fixfmt.h"
+#include <string.h>
+
+static char out[32];
+
+/* Format into out and compare text and returned length */
+#define CHECK_STR(call, text)                     \
+    do {                                          \
+        memset(out, '?', sizeof(out));            \
+        size_t n_ = (call);                       \
+        CHECK(strcmp(out, text) == 0);            \
+        CHECK_EQ(n_, strlen(text));               \
+    } while (0)
+
+static void test_integers(void)
+{
+    CHECK_STR(fixfmt_u32(out, sizeof(out), 0), "0");
+    CHECK_STR(fixfmt_u32(out, sizeof(out), UINT32_MAX), "4294967295");
+    CHECK_STR(fixfmt_i32(out, sizeof(out), -1), "-1");
+    CHECK_STR(fixfmt_i32(out, sizeof(out), INT32_MAX), "2147483647");
+    CHECK_STR(fixfmt_i32(out, sizeof(out), INT32_MIN), "-2147483648");
+}
+
+static void test_fixed(void)
+{
+    CHECK_STR(fixfmt_fixed(out, sizeof(out), 1234, 1), "123.4");
+    CHECK_STR(fixfmt_fixed(out, sizeof(out), -5, 2), "-0.05");
+    CHECK_STR(fixfmt_fixed(out, sizeof(out), INT32_MIN, 9), "-2.147483648");
+    CHECK_STR(fixfmt_fixed(out, sizeof(out), INT32_MAX, 0), "2147483647");
+}
+
+static void test_deg(void)
+{
+    CHECK_STR(fixfmt_deg(out, sizeof(out), 498421300, 6), "49.842130");
+    /* just below zero: the sign stays while the digits show it */
+    CHECK_STR(fixfmt_deg(out, sizeof(out), -1, 7), "-0.0000001");
+    CHECK_STR(fixfmt_deg(out, sizeof(out), -5, 6), "-0.000001");
+    /* rounded to zero: no "-0" */
+    CHECK_STR(fixfmt_deg(out, sizeof(out), -4, 6), "0.000000");
+    CHECK_STR(fixfmt_deg(out, sizeof(out), -338567000, 5), "-33.85670");
+    CHECK_STR(fixfmt_deg(out, sizeof(out), INT32_MIN, 7), "-214.7483648");
+    CHECK_STR(fixfmt_deg(out, sizeof(out), INT32_MAX, 7), "214.7483647");
+    CHECK_STR(fixfmt_deg(out, sizeof(out), INT32_MIN, 0), "-215");
+    CHECK_STR(fixfmt_deg(out, sizeof(out), INT32_MAX, 6), "214.748365");
+}
+
+static void test_dm(void)
+{
+    CHECK_STR(fixfmt_dm(out, sizeof(out), 498421300, 'N', 'S'), "49\x7F" "50.528' N");
+    /* 0.0000001 degree south is still south */
+    CHECK_STR(fixfmt_dm(out, sizeof(out), -1, 'N', 'S'), "00\x7F" "00.000' S");
+    CHECK_STR(fixfmt_dm(out, sizeof(out), -338567000, 'N', 'S'), "33\x7F" "51.402' S");
+    /* 49 59.99995' rounds to the next degree, 49 59.9995' does not */
+    CHECK_STR(fixfmt_dm(out, sizeof(out), 499999992, 'E', 'W'), "50\x7F" "00.000' E");
+    CHECK_STR(fixfmt_dm(out, sizeof(out), -499999992, 'E', 'W'), "50\x7F" "00.000' W");
+    CHECK_STR(fixfmt_dm(out, sizeof(out), 499999916, 'E', 'W'), "49\x7F" "59.999' E");
+    CHECK_STR(fixfmt_dm(out, sizeof(out), INT32_MIN, 'E', 'W'), "214\x7F" "44.902' W");
+    CHECK_STR(fixfmt_dm(out, sizeof(out), INT32_MAX, 'E', 'W'), "214\x7F" "44.902' E");
+}
+
+/* The text does not fit: "" and 0, nothing written past len */
+static void test_too_small(void)
+{
+    memset(out, '?', sizeof(out));
+    CHECK_EQ(fixfmt_u32(out, 10, UINT32_MAX), 0);
+    CHECK_EQ(out[0], '\0');
+    CHECK_EQ(out[10], '?');
+    CHECK_EQ(fixfmt_u32(out, 11, UINT32_MAX), 10);
+
+    memset(out, '?', sizeof(out));
+    CHECK_EQ(fixfmt_i32(out, 3, -10), 0);
+    CHECK_EQ(out[0], '\0');
+    CHECK_EQ(out[3], '?');
+    CHECK_EQ(fixfmt_deg(out, 10, -1, 7), 0);
+    CHECK_EQ(out[0], '\0');
+    CHECK_EQ(fixfmt_dm(out, 12, 498421300, 'N', 'S'), 0);
+    CHECK_EQ(out[0], '\0');
+    CHECK_EQ(fixfmt_dm(out, 13, 498421300, 'N', 'S'), 12);
+
+    /* a one-byte buffer only holds the terminator */
+    memset(out, '?', sizeof(out));
+    CHECK_EQ(fixfmt_u32(out, 1, 0), 0);
+    CHECK_EQ(out[0], '\0');
+    CHECK_EQ(out[1], '?');
+    /* no buffer at all */
+    CHECK_EQ(fixfmt_u32(out, 0, 7), 0);
+    CHECK_EQ(out[0], '\0');
+    CHECK_EQ(out[1], '?');
+    CHECK_EQ(fixfmt_u32(NULL, 8, 7), 0);
+}
+
+int main(void)
+{
+    test_integers();
+    test_fixed();
+    test_deg();
+    test_dm();
+    test_too_small();
+    return host_test_result("fixfmt");
+}
@@ -0,0 +1,94 @@
+/* frame: packet scanning resynchronises on the byte after a false SYNC and
+   never carries a frame over to the next packet */
+
+#include "host_test.h"
+#include "frame.h"
+#include <string.h>
+
+static uint8_t frames_found;
+static uint8_t last_type;
+static uint8_t last_len;
+static uint8_t last_payload[FRAME_MAX_PAYLOAD];
+
+static void scan(frame_parser_t *p, const uint8_t *data, size_t size)
+{
+    frames_found = 0;
+    frame_parser_packet(p, data, size);
+    while (frame_parser_next(p)) {
+        frames_found++;
+        last_type = p->type;
+        last_len = p->len;
+        memcpy(last_payload, p->payload, p->len);
+    }
+}
+
+static size_t make_frame(uint8_t *out, uint8_t type, uint8_t len, uint8_t seed)
+{
+    uint8_t payload[FRAME_MAX_PAYLOAD];
+    for (uint8_t i = 0; i < len; i++) payload[i] = (uint8_t)(seed + i);
+    return frame_encode(type, payload, len, out, FRAME_MAX_SIZE);
+}
+
+int main(void)
+{
+    frame_parser_t p;
+    uint8_t pkt[3 * FRAME_MAX_SIZE];
+    size_t n;
+
+    memset(&p, 0, sizeof(p));
+
+    /* one frame, and two back to back */
+    n = make_frame(pkt, FRAME_TYPE_TEXT, 5, 'a');
+    scan(&p, pkt, n);
+    CHECK_EQ(frames_found, 1);
+    CHECK_EQ(last_type, FRAME_TYPE_TEXT);
+    CHECK_EQ(last_len, 5);
+    CHECK(memcmp(last_payload, "abcde", 5) == 0);
+    n += make_frame(&pkt[n], FRAME_TYPE_GPS, 0, 0);
+    scan(&p, pkt, n);
+    CHECK_EQ(frames_found, 2);
+    CHECK_EQ(last_type, FRAME_TYPE_GPS);
+    CHECK_EQ(last_len, 0);
+    CHECK_EQ(p.crc_errors, 0);
+
+    /* A5 A5 00 11 in front of a full-size frame: the second A5 reads as a
+       frame header whose CRC bytes are the real frame's first two bytes */
+    static const uint8_t junk[4] = { 0xA5, 0xA5, 0x00, 0x11 };
+    memcpy(pkt, junk, sizeof(junk));
+    n = sizeof(junk) + make_frame(&pkt[sizeof(junk)], FRAME_TYPE_TEXT, FRAME_MAX_PAYLOAD, 0x30);
+    CHECK_EQ(n, sizeof(junk) + 58);
+    scan(&p, pkt, n);
+    CHECK_EQ(frames_found, 1);
+    CHECK_EQ(last_len, FRAME_MAX_PAYLOAD);
+    CHECK_EQ(last_payload[FRAME_MAX_PAYLOAD - 1], 0x30 + FRAME_MAX_PAYLOAD - 1);
+    CHECK_EQ(p.crc_errors, 2);
+
+    /* a corrupted frame followed by a good one */
+    p.crc_errors = 0;
+    n = make_frame(pkt, FRAME_TYPE_TEXT, 10, 'A');
+    pkt[5] ^= 0x01;
+    n += make_frame(&pkt[n], FRAME_TYPE_TEXT, 3, 'x');
+    scan(&p, pkt, n);
+    CHECK_EQ(frames_found, 1);
+    CHECK(memcmp(last_payload, "xyz", 3) == 0);
+    CHECK_EQ(p.crc_errors, 1);
+
+    /* a frame cut by the end of the packet is not completed by the next one */
+    p.crc_errors = 0;
+    n = make_frame(pkt, FRAME_TYPE_TEXT, 10, 'A');
+    scan(&p, pkt, 8);
+    CHECK_EQ(frames_found, 0);
+    CHECK_EQ(p.crc_errors, 1);
+    scan(&p, &pkt[8], n - 8);
+    CHECK_EQ(frames_found, 0);
+    scan(&p, pkt, n);
+    CHECK_EQ(frames_found, 1);
+
+    /* empty and NULL packets */
+    scan(&p, pkt, 0);
+    CHECK_EQ(frames_found, 0);
+    scan(&p, NULL, 10);
+    CHECK_EQ(frames_found, 0);
+
+    return host_test_result("frame");
+}
@@ -0,0 +1,204 @@
+/* gps_codec: key / delta reports round-trip exactly, never exceed a key
+   report, keep the sign of large deltas, survive the 7-bit seq wrap, and a
+   lost report stops the deltas until the next key report */
+
+#include "host_test.h"
+#include "gps_codec.h"
+#include <string.h>
+
+static int fix_eq(const gps_fix_t *a, const gps_fix_t *b)
+{
+    return a->lat_e7 == b->lat_e7 && a->lon_e7 == b->lon_e7 && a->alt_dm == b->alt_dm;
+}
+
+static int is_key(const uint8_t *report)
+{
+    return (report[0] & 0x80) == 0;
+}
+
+/* A walk of about a metre per report */
+static void walk(gps_fix_t *f, uint32_t i)
+{
+    f->lat_e7 += (int32_t)(90 + (i % 7) * 3);
+    f->lon_e7 -= (int32_t)(130 + (i % 5) * 11);
+    f->alt_dm = (int16_t)(f->alt_dm + ((i & 1) ? 2 : -1));
+}
+
+/* Key report first, then deltas of a few bytes; every report decodes to the
+   fix that was encoded */
+static void test_round_trip(void)
+{
+    gps_codec_t tx, rx;
+    gps_fix_t fix = { 498421300, 240299990, 2965 };
+    gps_fix_t got;
+    uint8_t report[GPS_CODEC_MAX_SIZE];
+
+    gps_codec_init(&tx);
+    gps_codec_init(&rx);
+    for (uint32_t i = 0; i < 40; i++) {
+        size_t n = gps_encode(&tx, &fix, report, sizeof(report));
+        if (i == 0) {
+            CHECK(is_key(report));
+            CHECK_EQ(n, GPS_CODEC_KEY_SIZE);
+        } else if (!is_key(report)) {
+            CHECK(n >= 4 && n <= 7);
+        }
+        CHECK(gps_decode(&rx, report, n, &got));
+        CHECK(fix_eq(&got, &fix));
+        walk(&fix, i);
+    }
+
+    /* too small an output buffer */
+    CHECK_EQ(gps_encode(&tx, &fix, report, GPS_CODEC_MAX_SIZE - 1), 0);
+}
+
+/* Whatever the jump, a report is at most a key report: under 12 bytes */
+static void test_size(void)
+{
+    gps_codec_t tx, rx;
+    gps_fix_t fix, got;
+    uint8_t report[GPS_CODEC_MAX_SIZE];
+    uint32_t seed = 1;
+
+    CHECK(GPS_CODEC_MAX_SIZE < 12);
+    gps_codec_init(&tx);
+    gps_codec_init(&rx);
+    for (uint32_t i = 0; i < 2000; i++) {
+        seed = seed * 1664525u + 1013904223u;
+        /* jumps of every magnitude, from centimetres to the whole range */
+        uint32_t mask = (1u << (seed % 32)) - 1u;
+        fix.lat_e7 = (int32_t)(seed & mask);
+        fix.lon_e7 = -(int32_t)((seed >> 3) & mask);
+        fix.alt_dm = (int16_t)(seed >> 16);
+        size_t n = gps_encode(&tx, &fix, report, sizeof(report));
+        CHECK(n >= 4 && n <= GPS_CODEC_MAX_SIZE);
+        CHECK(gps_decode(&rx, report, n, &got));
+        CHECK(fix_eq(&got, &fix));
+    }
+}
+
+/* Deltas near +/-2^31 keep their sign through zigzag; a jump across the
+   int32 range or the 180 meridian wraps modulo 2^32 */
+static void test_large_deltas(void)
+{
+    static const gps_fix_t path[] = {
+        { 0, 0, 0 },
+        { -1073741824, 0, 0 },              /* -2^30 */
+        { 0, 0, 0 },                        /* +2^30 */
+        { 1073741823, 5, -32768 },
+        { -1073741825, 5, 32767 },          /* -2^31 */
+        { INT32_MAX, 1799999999, 0 },
+        { INT32_MIN, -1799999999, -1 },     /* +1 and across the meridian */
+        { -900000000, 1800000000, 0 },
+        { 900000000, -1800000000, 0 },
+    };
+    gps_codec_t tx, rx;
+    gps_fix_t got;
+    uint8_t report[GPS_CODEC_MAX_SIZE];
+    uint8_t deltas = 0;
+
+    gps_codec_init(&tx);
+    gps_codec_init(&rx);
+    for (uint8_t i = 0; i < sizeof(path) / sizeof(path[0]); i++) {
+        size_t n = gps_encode(&tx, &path[i], report, sizeof(report));
+        if (i > 0 && !is_key(report)) deltas++;
+        CHECK(gps_decode(&rx, report, n, &got));
+        CHECK(fix_eq(&got, &path[i]));
+    }
+    /* the large steps went out as deltas, not as key reports */
+    CHECK(deltas >= 5);
+}
+
+/* seq counts 0..127 and wraps; the delta chain runs through the wrap */
+static void test_seq_wrap(void)
+{
+    gps_codec_t tx, rx;
+    gps_fix_t fix = { 100000000, 200000000, 10 };
+    gps_fix_t got;
+    uint8_t report[GPS_CODEC_MAX_SIZE];
+
+    gps_codec_init(&tx);
+    gps_codec_init(&rx);
+    for (uint32_t i = 0; i < 300; i++) {
+        size_t n = gps_encode(&tx, &fix, report, sizeof(report));
+        CHECK_EQ(report[0] & 0x7F, i & 0x7F);
+        CHECK(gps_decode(&rx, report, n, &got));
+        CHECK(fix_eq(&got, &fix));
+        walk(&fix, i);
+    }
+}
+
+/* A key report every GPS_CODEC_KEY_INTERVAL reports, deltas in between */
+static void test_key_interval(void)
+{
+    gps_codec_t tx;
+    gps_fix_t fix = { 498421300, 240299990, 2965 };
+    uint8_t report[GPS_CODEC_MAX_SIZE];
+
+    gps_codec_init(&tx);
+    for (uint32_t i = 0; i < 3 * GPS_CODEC_KEY_INTERVAL + 1; i++) {
+        gps_encode(&tx, &fix, report, sizeof(report));
+        CHECK_EQ(is_key(report), (i % GPS_CODEC_KEY_INTERVAL) == 0);
+        walk(&fix, i);
+    }
+}
+
+/* After a lost report every delta is refused, without touching the output,
+   until the next key report restarts the chain */
+static void test_lost_report(void)
+{
+    gps_codec_t tx, rx;
+    gps_fix_t fix = { 498421300, 240299990, 2965 };
+    gps_fix_t got, marker = { 1, 2, 3 };
+    uint8_t report[GPS_CODEC_MAX_SIZE];
+    uint32_t decoded = 0;
+
+    gps_codec_init(&tx);
+    gps_codec_init(&rx);
+
+    /* a delta before any key report */
+    gps_codec_t early = tx;
+    gps_encode(&early, &fix, report, sizeof(report));
+    size_t n = gps_encode(&early, &fix, report, sizeof(report));
+    CHECK(!is_key(report));
+    CHECK(!gps_decode(&rx, report, n, &got));
+
+    for (uint32_t i = 0; i < 2 * GPS_CODEC_KEY_INTERVAL - 1; i++) {
+        n = gps_encode(&tx, &fix, report, sizeof(report));
+        if (i == 3) {
+            walk(&fix, i);
+            continue;  /* lost on the air */
+        }
+        got = marker;
+        uint8_t ok = gps_decode(&rx, report, n, &got);
+        if (i < 3 || i >= GPS_CODEC_KEY_INTERVAL) {
+            CHECK(ok);
+            CHECK(fix_eq(&got, &fix));
+            decoded++;
+        } else {
+            CHECK(!ok);
+            CHECK(fix_eq(&got, &marker));
+        }
+        walk(&fix, i);
+    }
+    CHECK_EQ(decoded, 3 + GPS_CODEC_KEY_INTERVAL - 1);
+
+    /* malformed reports: a truncated delta, a short key report */
+    n = gps_encode(&tx, &fix, report, sizeof(report));
+    CHECK(!is_key(report));
+    CHECK(!gps_decode(&rx, report, n - 1, &got));
+    CHECK(!gps_decode(&rx, report, 0, &got));
+    report[0] = 0x05;
+    CHECK(!gps_decode(&rx, report, GPS_CODEC_KEY_SIZE - 1, &got));
+}
+
+int main(void)
+{
+    test_round_trip();
+    test_size();
+    test_large_deltas();
+    test_seq_wrap();
+    test_key_interval();
+    test_lost_report();
+    return host_test_result("gps_codec");
+}
@@ -0,0 +1,80 @@
+/* msglog: a new message redraws only the rows it lands on. The bus cost per
+   message is measured here; msglog.h quotes these figures. */
+
+#include "host_test.h"
+#include "console.h"
+#include "msglog.h"
+#include "ssd1306_emu.h"
+#include <string.h>
+
+/* Bus cost of adding text and flushing */
+static void add_and_flush(const char *text, emu_counters_t *c)
+{
+    emu_counters_reset();
+    msglog_add(text);
+    CHECK(ssd1306_flush() == HAL_OK);
+    emu_counters_get(c);
+}
+
+static char report[MSGLOG_DEPTH * 48];
+
+static void collect(const char *line)
+{
+    strcat(report, line);
+}
+
+int main(void)
+{
+    emu_counters_t c;
+    char text[MSGLOG_TEXT_MAX];
+
+    emu_reset();
+    ssd1306_init();
+    console_clear();
+    CHECK(ssd1306_flush() == HAL_OK);
+
+    /* fill the screen so every further message scrolls */
+    for (uint8_t i = 0; i < CONSOLE_ROWS; i++) {
+        text[0] = (char)('a' + i);
+        text[1] = '\0';
+        msglog_add(text);
+    }
+    CHECK(ssd1306_flush() == HAL_OK);
+
+    /* "MM:SS " + up to 15 characters: one row */
+    add_and_flush("fifteen chars..", &c);
+    printf("msglog: 15 chars: %u transactions, %u bytes\n", (unsigned)c.transactions, (unsigned)c.payload_bytes);
+    CHECK_EQ(c.transactions, 3);
+    CHECK_EQ(c.payload_bytes, 136);
+    CHECK_EQ(c.data_bytes, CONSOLE_COLS * CONSOLE_CELL_WIDTH);
+
+    /* 16 characters and more wrap onto a second row */
+    add_and_flush("sixteen chars...", &c);
+    printf("msglog: 16 chars: %u transactions, %u bytes\n", (unsigned)c.transactions, (unsigned)c.payload_bytes);
+    CHECK_EQ(c.transactions, 5);
+    CHECK_EQ(c.payload_bytes, 270);
+    CHECK_EQ(c.data_bytes, 2 * CONSOLE_COLS * CONSOLE_CELL_WIDTH);
+
+    memset(text, 'w', sizeof(text) - 1);
+    text[sizeof(text) - 1] = '\0';
+    add_and_flush(text, &c);
+    printf("msglog: %u chars: %u transactions, %u bytes\n", (unsigned)(sizeof(text) - 1),
+           (unsigned)c.transactions, (unsigned)c.payload_bytes);
+    CHECK_EQ(c.data_bytes, 2 * CONSOLE_COLS * CONSOLE_CELL_WIDTH);
+    check_golden("msglog");
+
+    /* history, oldest first, as the E32 "#log" report sends it */
+    CHECK_EQ(msglog_count(), CONSOLE_ROWS + 3);
+    CHECK(strcmp(msglog_get(1)->text, "sixteen chars...") == 0);
+    msglog_report(collect);
+    CHECK(strncmp(report, "00:00 a\n", 8) == 0);
+    CHECK(strstr(report, "sixteen chars...\n") != NULL);
+    CHECK_EQ(strlen(report), (CONSOLE_ROWS + 3) * 6 + CONSOLE_ROWS * 2 + 16 + 17 + MSGLOG_TEXT_MAX);
+
+    /* the ring keeps the last MSGLOG_DEPTH messages */
+    for (uint8_t i = 0; i < MSGLOG_DEPTH; i++) msglog_add("x");
+    CHECK_EQ(msglog_count(), MSGLOG_DEPTH);
+    CHECK(msglog_get(MSGLOG_DEPTH) == NULL);
+
+    return host_test_result("msglog");
+}
@@ -0,0 +1,57 @@
+/* pool: a double free or a foreign pointer is refused and counted instead of
+   corrupting the free list or the used count */
+
+#include "host_test.h"
+#include "pool.h"
+
+POOL_STORAGE(test_storage, 10, 4);
+
+int main(void)
+{
+    pool_t pool;
+    void *b[4];
+
+    pool_init(&pool, test_storage, 10, 4);
+    for (uint8_t i = 0; i < 4; i++) b[i] = pool_alloc(&pool);
+    CHECK(pool_alloc(&pool) == NULL);
+    CHECK_EQ(pool_used(&pool), 4);
+
+    /* not blocks of this pool */
+    pool_free(&pool, (uint8_t *)b[1] + 4);
+    pool_free(&pool, &pool);
+    CHECK_EQ(pool_bad_frees(&pool), 2);
+    CHECK_EQ(pool_used(&pool), 4);
+
+    for (uint8_t i = 0; i < 4; i++) pool_free(&pool, b[i]);
+    CHECK_EQ(pool_used(&pool), 0);
+
+    /* nothing in use: any further free is a double free */
+    pool_free(&pool, b[2]);
+    CHECK_EQ(pool_used(&pool), 0);
+    CHECK_EQ(pool_bad_frees(&pool), 3);
+
+#if POOL_CHECK_FREE
+    /* a block freed twice while others are in use */
+    b[0] = pool_alloc(&pool);
+    b[1] = pool_alloc(&pool);
+    pool_free(&pool, b[0]);
+    pool_free(&pool, b[0]);
+    CHECK_EQ(pool_used(&pool), 1);
+    CHECK_EQ(pool_bad_frees(&pool), 4);
+#endif
+
+    /* the free list is intact: every block once, then empty */
+    pool_init(&pool, test_storage, 10, 4);
+    b[0] = pool_alloc(&pool);
+    pool_free(&pool, b[0]);
+    pool_free(&pool, b[0]);
+    for (uint8_t i = 0; i < 4; i++) {
+        b[i] = pool_alloc(&pool);
+        CHECK(b[i] != NULL);
+        for (uint8_t j = 0; j < i; j++) CHECK(b[i] != b[j]);
+    }
+    CHECK(pool_alloc(&pool) == NULL);
+    CHECK_EQ(pool_used(&pool), 4);
+
+    return host_test_result("pool");
+}
@@ -0,0 +1,110 @@
+/* prof: with PROF_ENABLE the driver and E32 probes fire on their paths,
+   prof_dump() reports count / min / max / mean in ns from clock_gettime,
+   and "#prof" sends the same table over the radio */
+
+#include "host_test.h"
+#include "prof.h"
+#include "ssd1306.h"
+#include "ssd1306_emu.h"
+#include "e32.h"
+#include "e32_sim.h"
+#include "stackmon.h"
+#include <stdio.h>
+#include <string.h>
+
+void stackmon_report(void (*out)(const char *line))
+{
+    out("stack n/a\n");
+}
+
+static char report[512];
+
+static void collect(const char *line)
+{
+    strcat(report, line);
+}
+
+/* The probe's line in text: count, and min <= mean <= max */
+static uint32_t probe_count(const char *text, const char *name)
+{
+    char key[32];
+    unsigned long count, min, max, mean;
+
+    snprintf(key, sizeof(key), "\n%s ", name);
+    const char *line = strstr(text, key);
+    if (line == NULL) return 0;
+    CHECK_EQ(sscanf(line + strlen(key), "%lu %lu %lu %lu", &count, &min, &max, &mean), 4);
+    CHECK(min <= mean);
+    CHECK(mean <= max);
+    return (uint32_t)count;
+}
+
+static void test_driver(void)
+{
+    uint8_t ramp[16];
+
+    emu_reset();
+    ssd1306_init();
+    CHECK(ssd1306_clear() == HAL_OK);
+    CHECK(ssd1306_flush() == HAL_OK);
+    PROF_INIT();
+
+    report[0] = '\0';
+    prof_dump(collect);
+    CHECK(strcmp(report, "probe count min max mean (ns)\n") == 0);
+
+    /* one window and one data stream per dirty page: pages 0 and 2 on the
+       first flush, page 2 on the others */
+    CHECK(ssd1306_draw_text(&ssd1306_font_5x8, 0, 0, "prof") == HAL_OK);
+    for (uint8_t i = 0; i < 3; i++) {
+        CHECK(ssd1306_write_string(0, 2, "x") == HAL_OK);
+        CHECK(ssd1306_flush() == HAL_OK);
+    }
+    for (uint8_t i = 0; i < sizeof(ramp); i++) ramp[i] = (uint8_t)i;
+    CHECK(ssd1306_set_window(0, 15, 4, 4) == HAL_OK);
+    CHECK(ssd1306_data(ramp, sizeof(ramp)) == HAL_OK);
+
+    report[0] = '\0';
+    prof_dump(collect);
+    printf("%s", report);
+    CHECK_EQ(probe_count(report, "ssd1306_glyph"), 4 + 3);
+    CHECK_EQ(probe_count(report, "ssd1306_flush"), 3);
+    CHECK_EQ(probe_count(report, "ssd1306_set_window"), 2 + 1 + 1 + 1);
+    CHECK_EQ(probe_count(report, "ssd1306_data"), 2 + 1 + 1 + 1);
+    CHECK_EQ(probe_count(report, "e32_rx_event"), 0);
+
+    prof_reset();
+    report[0] = '\0';
+    prof_dump(collect);
+    CHECK(strcmp(report, "probe count min max mean (ns)\n") == 0);
+}
+
+/* Receive events are probed in the UART callback; "#prof" answers on air */
+static void test_e32(void)
+{
+    static const uint8_t text[] = "hello\n";
+
+    e32_sim_reset();
+    E32_StartReceive();
+    for (uint8_t i = 0; i < 3; i++) {
+        e32_sim_receive(text, sizeof(text) - 1);
+        HAL_Delay(2);
+    }
+    e32_sim_receive((const uint8_t *)"#prof", 5);
+    HAL_Delay(2);
+    E32_Poll();
+    HAL_Delay(500);
+
+    CHECK(e32_sim.air_len < sizeof(report));
+    memcpy(report, e32_sim.air, e32_sim.air_len);
+    report[e32_sim.air_len] = '\0';
+    CHECK(strncmp(report, "probe count min max mean (ns)\n", 30) == 0);
+    CHECK_EQ(probe_count(report, "e32_rx_event"), 4);
+}
+
+int main(void)
+{
+    test_driver();
+    test_e32();
+    return host_test_result("prof");
+}
@@ -0,0 +1,182 @@
+/* Background flush (SSD1306_USE_DMA with a framebuffer) against the I2C
+   model with DMA completion driven by the test: every emu_dma_complete() is
+   one transfer-complete interrupt. */
+
+#include "host_test.h"
+#include "ssd1306.h"
+#include "ssd1306_emu.h"
+#include <string.h>
+
+static unsigned done_calls;
+static HAL_StatusTypeDef done_status;
+
+static void on_done(HAL_StatusTypeDef status)
+{
+    done_calls++;
+    done_status = status;
+}
+
+/* Run the in-flight flush to completion, one interrupt at a time */
+static unsigned run_dma(void)
+{
+    unsigned steps = 0;
+    while (emu_dma_pending() && steps < 100) {
+        emu_dma_complete();
+        steps++;
+    }
+    CHECK(!ssd1306_busy());
+    return steps;
+}
+
+/* The panel shows exactly the framebuffer */
+static int panel_matches_fb(void)
+{
+    const uint8_t *fb = ssd1306_framebuffer();
+    for (uint8_t p = 0; p < SSD1306_PAGES; p++) {
+        for (uint8_t c = 0; c < SSD1306_WIDTH; c++) {
+            if (emu_ram(p, c) != fb[p * SSD1306_WIDTH + c]) return 0;
+        }
+    }
+    return 1;
+}
+
+static void boot(void)
+{
+    emu_reset();
+    ssd1306_init();
+    ssd1306_clear();
+    CHECK(ssd1306_flush() == HAL_OK);
+    emu_dma_auto(0);
+    ssd1306_set_done_callback(on_done);
+    done_calls = 0;
+}
+
+static void test_flush_async(void)
+{
+    boot();
+    ssd1306_write_string(0, 2, "async");
+    ssd1306_write_string(64, 5, "flush");
+    CHECK(ssd1306_flush_async() == HAL_OK);
+    CHECK(ssd1306_busy());
+    CHECK(ssd1306_flush_async() == HAL_BUSY);
+    /* two spans: window + data each */
+    CHECK_EQ(run_dma(), 4);
+    CHECK_EQ(done_calls, 1);
+    CHECK_EQ(done_status, HAL_OK);
+    CHECK(panel_matches_fb());
+}
+
+/* Nothing dirty: no transfer and no callback */
+static void test_clean_no_callback(void)
+{
+    boot();
+    CHECK(ssd1306_flush_async() == HAL_OK);
+    CHECK(!emu_dma_pending());
+    CHECK(!ssd1306_busy());
+    CHECK_EQ(done_calls, 0);
+}
+
+/* Drawing while the flush runs lands in the dirty table, not in the flush */
+static void test_draw_during_flush(void)
+{
+    boot();
+    ssd1306_write_string(0, 0, "first");
+    ssd1306_write_string(0, 4, "second");
+    CHECK(ssd1306_flush_async() == HAL_OK);
+    emu_dma_complete(); /* page 0 window */
+    emu_dma_complete(); /* page 0 data */
+    ssd1306_write_string(0, 0, "FIRST");  /* already sent */
+    ssd1306_write_string(0, 6, "third");  /* not part of this flush */
+    run_dma();
+    CHECK_EQ(done_calls, 1);
+    CHECK(!panel_matches_fb());
+
+    CHECK(ssd1306_flush_async() == HAL_OK);
+    CHECK_EQ(run_dma(), 4);
+    CHECK_EQ(done_calls, 2);
+    CHECK(panel_matches_fb());
+}
+
+/* A NACK mid-flush reports the error; the unsent spans are merged back by
+   the next flush, together with anything drawn in between */
+static void test_error_retry(void)
+{
+    boot();
+    ssd1306_write_string(0, 1, "page one");
+    ssd1306_write_string(0, 3, "page three");
+    CHECK(ssd1306_flush_async() == HAL_OK);
+    emu_dma_complete(); /* page 1 window */
+    emu_fail_next(1);
+    emu_dma_complete(); /* page 1 data: NACK */
+    CHECK(!ssd1306_busy());
+    CHECK_EQ(done_calls, 1);
+    CHECK_EQ(done_status, HAL_ERROR);
+    CHECK(!emu_dma_pending());
+
+    ssd1306_write_string(0, 7, "page seven");
+    CHECK(ssd1306_flush_async() == HAL_OK);
+    CHECK_EQ(run_dma(), 6);
+    CHECK_EQ(done_calls, 2);
+    CHECK_EQ(done_status, HAL_OK);
+    CHECK(panel_matches_fb());
+
+    /* the same through the blocking flush */
+    ssd1306_write_string(0, 2, "blocking");
+    CHECK(ssd1306_flush_async() == HAL_OK);
+    emu_fail_next(1);
+    emu_dma_complete();
+    CHECK_EQ(done_status, HAL_ERROR);
+    emu_dma_auto(1);
+    CHECK(ssd1306_flush() == HAL_OK);
+    CHECK(panel_matches_fb());
+}
+
+/* A start line requested mid-flush is not sent by the running flush (its
+   rows may not be on the panel yet) but by the next one, after the data */
+static void test_start_line_after_flush(void)
+{
+    emu_counters_t c;
+    boot();
+    ssd1306_write_string(0, 3, "old row");
+    CHECK(ssd1306_flush_async() == HAL_OK);
+    emu_dma_complete(); /* page 3 window */
+    CHECK(ssd1306_set_start_line(24) == HAL_OK);
+    ssd1306_write_string(0, 3, "new row");
+    run_dma();
+    CHECK_EQ(emu_start_line(), 0);
+
+    CHECK(ssd1306_flush_async() == HAL_OK);
+    run_dma();
+    emu_counters_get(&c);
+    CHECK_EQ(emu_start_line(), 24);
+    CHECK(c.start_line_seq > c.last_data_seq);
+    CHECK(panel_matches_fb());
+}
+
+/* A failed start line command is retried by the next flush */
+static void test_start_line_error(void)
+{
+    boot();
+    CHECK(ssd1306_set_start_line(8) == HAL_OK);
+    CHECK(ssd1306_flush_async() == HAL_OK);
+    emu_fail_next(1);
+    emu_dma_complete();
+    CHECK_EQ(done_status, HAL_ERROR);
+    CHECK_EQ(emu_start_line(), 0);
+
+    CHECK(ssd1306_flush_async() == HAL_OK);
+    CHECK_EQ(run_dma(), 1);
+    CHECK_EQ(done_status, HAL_OK);
+    CHECK_EQ(emu_start_line(), 8);
+}
+
+int main(void)
+{
+    test_flush_async();
+    test_clean_no_callback();
+    test_draw_during_flush();
+    test_error_retry();
+    test_start_line_after_flush();
+    test_start_line_error();
+    return host_test_result("ssd1306_async");
+}
@@ -0,0 +1,73 @@
+/* Runs ssd1306_bench_run() against the I2C model and writes its CSV to
+   ssd1306_bench_<config>.csv in the working directory (and stdout). The
+   transaction and byte counts of every workload must match what the model
+   saw on the bus; the us_* columns are modeled from those counts by
+   ssd1306_stats_bus_time_us(), they are not measured. */
+
+#include "host_test.h"
+#include "ssd1306.h"
+#include "ssd1306_emu.h"
+#include <stdio.h>
+#include <string.h>
+
+#ifndef BENCH_CONFIG
+#define BENCH_CONFIG "default"
+#endif
+
+/* Payload bytes of the coordinates view workloads */
+#if SSD1306_USE_FRAMEBUFFER
+#define COORDS_FULL_BYTES   776
+#define COORDS_UPDATE_BYTES 96
+#else
+#define COORDS_FULL_BYTES   792
+#define COORDS_UPDATE_BYTES 72
+#endif
+
+static FILE *csv;
+static unsigned rows;
+static emu_counters_t prev;
+
+static void bench_out(const char *line)
+{
+    emu_counters_t now;
+    char name[32];
+    unsigned long transactions, payload, us[3];
+
+    fputs(line, stdout);
+    if (csv != NULL) fputs(line, csv);
+
+    emu_counters_get(&now);
+    if (sscanf(line, "%31[^,],%lu,%lu,%lu,%lu,%lu", name, &transactions, &payload,
+               &us[0], &us[1], &us[2]) == 6) {
+        CHECK_EQ(transactions, now.transactions - prev.transactions);
+        CHECK_EQ(payload, now.payload_bytes - prev.payload_bytes);
+        /* slower bus, longer modeled time */
+        CHECK(us[0] >= us[1] && us[1] >= us[2]);
+        if (strcmp(name, "coords_full") == 0) CHECK_EQ(payload, COORDS_FULL_BYTES);
+        if (strcmp(name, "coords_update") == 0) CHECK_EQ(payload, COORDS_UPDATE_BYTES);
+        rows++;
+    }
+    prev = now;
+}
+
+int main(void)
+{
+    const char *path = "ssd1306_bench_" BENCH_CONFIG ".csv";
+
+    emu_reset();
+    ssd1306_init();
+    ssd1306_clear();
+    ssd1306_flush();
+    emu_counters_get(&prev);
+
+    csv = fopen(path, "w");
+    CHECK(csv != NULL);
+    ssd1306_bench_run(bench_out);
+    if (csv != NULL) fclose(csv);
+
+    CHECK_EQ(rows, 7);
+    emu_counters_get(&prev);
+    CHECK_EQ(prev.protocol_errors, 0);
+    printf("written to %s\n", path);
+    return host_test_result("ssd1306_bench");
+}
@@ -0,0 +1,226 @@
+/* Rendering through the real driver into the SSD1306 model, compared with
+   golden panel images. Built once per driver configuration (framebuffer with
+   DMA, framebuffer blocking, direct); all of them must produce the same
+   pixels except where the direct mode documents a difference. */
+
+#include "host_test.h"
+#include "ssd1306.h"
+#include "ssd1306_emu.h"
+#include <string.h>
+
+#if SSD1306_USE_FRAMEBUFFER
+static uint8_t dump[EMU_PBM_SIZE];
+static size_t dump_len;
+
+static void dump_out(const uint8_t *buf, size_t len)
+{
+    if (dump_len + len <= sizeof(dump)) memcpy(&dump[dump_len], buf, len);
+    dump_len += len;
+}
+
+/* ssd1306_dump_pbm() must show exactly what reached the panel */
+static void check_dump_matches_panel(void)
+{
+    static uint8_t panel[EMU_PBM_SIZE];
+    emu_pbm(panel);
+    dump_len = 0;
+    ssd1306_dump_pbm(dump_out);
+    CHECK_EQ(dump_len, sizeof(panel));
+    CHECK(memcmp(dump, panel, sizeof(panel)) == 0);
+}
+#else
+static void check_dump_matches_panel(void) { }
+#endif
+
+static void check_protocol(void)
+{
+    emu_counters_t c;
+    emu_counters_get(&c);
+    CHECK_EQ(c.protocol_errors, 0);
+}
+
+/* Power-on noise in GDDRAM, then the boot sequence of main.c */
+static void boot(void)
+{
+    emu_reset();
+    ssd1306_init();
+    CHECK(ssd1306_clear() == HAL_OK);
+    CHECK(ssd1306_flush() == HAL_OK);
+}
+
+/* Nothing is dirty before init: a flush must not touch the bus */
+static void test_flush_before_init(void)
+{
+    emu_counters_t c;
+    emu_reset();
+    CHECK(ssd1306_flush() == HAL_OK);
+    emu_counters_get(&c);
+    CHECK_EQ(c.transactions, 0);
+}
+
+static void test_clear(void)
+{
+    boot();
+    for (uint8_t p = 0; p < EMU_PAGES; p++) {
+        for (uint8_t c = 0; c < EMU_WIDTH; c++) CHECK_EQ(emu_ram(p, c), 0);
+    }
+    CHECK_EQ(emu_start_line(), 0);
+    check_golden("clear");
+    check_dump_matches_panel();
+    check_protocol();
+}
+
+static void test_text(void)
+{
+    boot();
+    /* unaligned rows, each text on pages of its own (direct mode clears the
+       rest of every page it touches) */
+    CHECK(ssd1306_draw_text(&ssd1306_font_5x8, 0, 0, "Hello, SSD1306!") == HAL_OK);
+    CHECK(ssd1306_draw_text(&ssd1306_font_7x10, 4, 11, "7x10 y=11") == HAL_OK);
+    CHECK(ssd1306_draw_text(&ssd1306_font_5x8p, 0, 24, "Proportional 5x8 Wi") == HAL_OK);
+    CHECK(ssd1306_draw_text(&ssd1306_font_7x10p, 0, 35, "7x10p iljW") == HAL_OK);
+    CHECK(ssd1306_write_string(0, 7, "page 7 ~{|}") == HAL_OK);
+    /* clipped at the right edge */
+    CHECK(ssd1306_write_string(110, 6, "edge") == HAL_OK);
+    CHECK(ssd1306_flush() == HAL_OK);
+    check_golden("text");
+    check_dump_matches_panel();
+    check_protocol();
+}
+
+static void test_window(void)
+{
+    static const uint8_t bar[8] = { 0xFF, 0x81, 0x81, 0x81, 0x81, 0x81, 0x81, 0xFF };
+    uint8_t checker[2 * 40];
+
+    for (uint8_t i = 0; i < sizeof(checker); i++) checker[i] = (i & 1) ? 0xAA : 0x55;
+
+    boot();
+    /* 40 x 2 pages at column 100: the block is clipped to 28 columns */
+    CHECK(ssd1306_write_block(100, 5, 40, 2, checker) == HAL_OK);
+    CHECK(ssd1306_write_block(0, 0, sizeof(bar), 1, bar) == HAL_OK);
+    CHECK(ssd1306_write_block(60, 3, 4, 1, &checker[1]) == HAL_OK);
+    CHECK(ssd1306_flush() == HAL_OK);
+    check_dump_matches_panel();
+
+    /* raw window write: 0x21/0x22 then a data stream that wraps at col1 */
+    CHECK(ssd1306_set_window(120, 127, 1, 2) == HAL_OK);
+    uint8_t ramp[16];
+    for (uint8_t i = 0; i < sizeof(ramp); i++) ramp[i] = (uint8_t)(1u << (i & 7));
+    CHECK(ssd1306_data(ramp, sizeof(ramp)) == HAL_OK);
+    check_golden("window");
+    check_protocol();
+}
+
+static void fill(void)
+{
+    uint8_t ones[SSD1306_WIDTH];
+    memset(ones, 0xFF, sizeof(ones));
+    for (uint8_t p = 0; p < SSD1306_PAGES; p++) {
+        CHECK(ssd1306_write_block(0, p, SSD1306_WIDTH, 1, ones) == HAL_OK);
+    }
+}
+
+static void test_clear_rect(void)
+{
+    boot();
+    fill();
+    /* page aligned: the same in every mode */
+    CHECK(ssd1306_clear_rect(16, 8, 32, 16) == HAL_OK);
+    /* clipped at the bottom right corner */
+    CHECK(ssd1306_clear_rect(120, 56, 20, 20) == HAL_OK);
+    CHECK(ssd1306_flush() == HAL_OK);
+    check_golden("clear_rect");
+    check_dump_matches_panel();
+
+    /* rows 3..12: pixel exact with a framebuffer, whole pages without */
+    CHECK(ssd1306_clear_rect(70, 3, 20, 10) == HAL_OK);
+    CHECK(ssd1306_flush() == HAL_OK);
+#if SSD1306_USE_FRAMEBUFFER
+    check_golden("clear_rect_rows");
+#else
+    check_golden("clear_rect_rows_paged");
+#endif
+    check_dump_matches_panel();
+    check_protocol();
+}
+
+static void test_start_line(void)
+{
+    boot();
+    for (uint8_t p = 0; p < SSD1306_PAGES; p++) {
+        char line[] = "row 0 ----";
+        line[4] = (char)('0' + p);
+        CHECK(ssd1306_write_string((uint8_t)(p * 4), p, line) == HAL_OK);
+    }
+    CHECK(ssd1306_set_start_line(20) == HAL_OK);
+    CHECK(ssd1306_flush() == HAL_OK);
+    CHECK_EQ(ssd1306_get_start_line(), 20);
+    CHECK_EQ(emu_start_line(), 20);
+    check_golden("start_line");
+    check_dump_matches_panel();
+
+    /* clear resets the start line */
+    CHECK(ssd1306_clear() == HAL_OK);
+    CHECK(ssd1306_flush() == HAL_OK);
+    CHECK_EQ(emu_start_line(), 0);
+    check_golden("clear");
+    check_protocol();
+}
+
+/* The init table's segment remap and COM scan direction put column 0 /
+   row 0 top left; a changed 0xA1 or 0xC8 mirrors this image */
+static void test_orientation(void)
+{
+    static const uint8_t corner[3] = { 0x07, 0x01, 0x01 };
+
+    boot();
+    CHECK_EQ(emu_seg_remapped(), 1);
+    CHECK_EQ(emu_com_remapped(), 1);
+    CHECK(ssd1306_write_block(0, 0, sizeof(corner), 1, corner) == HAL_OK);
+    CHECK(ssd1306_write_string(8, 0, "top left") == HAL_OK);
+    CHECK(ssd1306_write_string(80, 7, "bottom") == HAL_OK);
+    CHECK(ssd1306_flush() == HAL_OK);
+    CHECK_EQ(emu_pixel(0, 0), 1);
+    CHECK_EQ(emu_pixel(2, 0), 1);
+    CHECK_EQ(emu_pixel(0, 2), 1);
+    CHECK_EQ(emu_pixel(EMU_WIDTH - 1, 0), 0);
+    CHECK_EQ(emu_pixel(0, EMU_HEIGHT - 1), 0);
+    check_golden("orientation");
+    check_dump_matches_panel();
+    check_protocol();
+}
+
+/* The coordinates view after a screen switch: clear does not know about
+   the view, the caller resets its cache */
+static void test_coords(void)
+{
+    boot();
+    ssd1306_write_string(0, 2, "console text");
+    CHECK(ssd1306_flush() == HAL_OK);
+    CHECK(ssd1306_clear() == HAL_OK);
+    Display_ResetCoordinates();
+    CHECK(Display_ShowCoordinatesE7(498421300, 240299990, 2965) == HAL_OK);
+    CHECK(ssd1306_flush() == HAL_OK);
+    check_golden("coords");
+    check_dump_matches_panel();
+
+    /* a new fix only redraws the cells that changed */
+    CHECK(Display_ShowCoordinatesE7(-338567000, 1512093000, -125) == HAL_OK);
+    CHECK(ssd1306_flush() == HAL_OK);
+    check_golden("coords_update");
+    check_protocol();
+}
+
+int main(void)
+{
+    test_flush_before_init();
+    test_clear();
+    test_text();
+    test_window();
+    test_clear_rect();
+    test_start_line();
+    test_orientation();
+    test_coords();
+    return host_test_result("ssd1306_golden");
+}
@@ -0,0 +1,313 @@
+/* Host-side font generator for the SSD1306 driver.
+
+   Reads the 7x10 glyph art (tools/fontgen/font7x10.txt) and writes a C source
+   with the glyphs already rotated into SSD1306 page-major bytes, so rendering
+   on the target is a straight copy out of flash. It also derives the
+   proportional variants of the 7x10 font and of font5x8 (linked in from
+   Core/Src/ssd1306_fonts.c) as ssd1306_font_t descriptors.
+
+   Usage: fontgen <font7x10.txt> <output.c>
+
+   Built and run by CMake with the host compiler; see CMakeLists.txt. */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "ssd1306_fonts.h"
+
+#define ART_COUNT    FONT7X10_COUNT
+#define ART_ROWS     FONT7X10_ROWS
+#define ART_COLS     FONT7X10_COLS
+#define ART_ADVANCE  (FONT7X10_COLS + 1)  /* glyph columns + one blank spacing column */
+#define MAX_COLS     8
+
+/* Blank width of the space glyph and gap after each glyph in the
+   proportional fonts */
+#define PROP_SPACE_5X8   2
+#define PROP_SPACE_7X10  3
+#define PROP_SPACING     1
+
+/* glyph_rows[glyph][row] = ART_COLS characters of '#'/'.' art */
+static char glyph_rows[ART_COUNT][ART_ROWS][ART_COLS + 1];
+/* glyph_line[glyph] = line of its header, 0 while not seen */
+static int glyph_line[ART_COUNT];
+
+/* A font in column form: cols[glyph][x] holds bit n = row n */
+typedef struct {
+    const char *name;
+    uint8_t height;
+    uint8_t ncols;
+    uint16_t cols[FONT_COUNT][MAX_COLS];
+} column_font_t;
+
+/* Strip trailing newline / carriage return / spaces */
+static void rstrip(char *s)
+{
+    size_t n = strlen(s);
+    while (n > 0 && (s[n - 1] == '\n' || s[n - 1] == '\r' || s[n - 1] == ' ')) s[--n] = '\0';
+}
+
+static int parse_font(const char *path)
+{
+    FILE *f = fopen(path, "r");
+    if (f == NULL) {
+        fprintf(stderr, "fontgen: cannot open %s\n", path);
+        return -1;
+    }
+
+    char line[128];
+    int lineno = 0;
+    int glyph = -1;
+    int row = ART_ROWS;
+
+    for (;;) {
+        int more = fgets(line, sizeof(line), f) != NULL;
+        if (more) {
+            lineno++;
+            rstrip(line);
+            if (line[0] == '\0' || line[0] == ';') continue;
+        }
+
+        /* A glyph ends at the next header or at the end of the file */
+        if (!more || (line[0] == '0' && line[1] == 'x')) {
+            if (glyph >= 0 && row != ART_ROWS) {
+                fprintf(stderr, "%s:%d: glyph 0x%02X has %d rows, expected %d\n",
+                        path, glyph_line[glyph], glyph + FONT7X10_FIRST_CHAR, row, ART_ROWS);
+                fclose(f);
+                return -1;
+            }
+        }
+        if (!more) break;
+
+        if (line[0] == '0' && line[1] == 'x') {
+            unsigned code = 0;
+            if (sscanf(line, "0x%x", &code) != 1 || code < FONT7X10_FIRST_CHAR ||
+                code >= FONT7X10_FIRST_CHAR + ART_COUNT) {
+                fprintf(stderr, "%s:%d: bad glyph header\n", path, lineno);
+                fclose(f);
+                return -1;
+            }
+            glyph = (int)code - FONT7X10_FIRST_CHAR;
+            if (glyph_line[glyph] != 0) {
+                fprintf(stderr, "%s:%d: glyph 0x%02X already defined at line %d\n",
+                        path, lineno, code, glyph_line[glyph]);
+                fclose(f);
+                return -1;
+            }
+            glyph_line[glyph] = lineno;
+            row = 0;
+            continue;
+        }
+
+        if (glyph < 0 || row >= ART_ROWS || strlen(line) != ART_COLS || strspn(line, "#.") != ART_COLS) {
+            fprintf(stderr, "%s:%d: expected %d pixels of '#'/'.'\n", path, lineno, ART_COLS);
+            fclose(f);
+            return -1;
+        }
+        memcpy(glyph_rows[glyph][row], line, ART_COLS + 1);
+        row++;
+    }
+    fclose(f);
+
+    for (int i = 0; i < ART_COUNT; i++) {
+        if (glyph_line[i] == 0) {
+            fprintf(stderr, "%s: glyph 0x%02X missing\n", path, i + FONT7X10_FIRST_CHAR);
+            return -1;
+        }
+    }
+    return 0;
+}
+
+static void art_to_columns(column_font_t *cf)
+{
+    cf->name = "7x10";
+    cf->height = ART_ROWS;
+    cf->ncols = ART_COLS;
+    for (int i = 0; i < ART_COUNT; i++) {
+        for (int col = 0; col < ART_COLS; col++) {
+            uint16_t bits = 0;
+            for (int row = 0; row < ART_ROWS; row++) {
+                if (glyph_rows[i][row][col] == '#') bits |= (uint16_t)(1u << row);
+            }
+            cf->cols[i][col] = bits;
+        }
+    }
+}
+
+static void font5x8_to_columns(column_font_t *cf)
+{
+    cf->name = "5x8";
+    cf->height = 8;
+    cf->ncols = 5;
+    for (int i = 0; i < FONT_COUNT; i++) {
+        for (int col = 0; col < 5; col++) cf->cols[i][col] = font5x8[i][col];
+    }
+}
+
+/* Inked column range of a glyph; returns 0 for a blank glyph */
+static int glyph_extent(const column_font_t *cf, int glyph, int *first, int *last)
+{
+    *first = -1;
+    *last = -1;
+    for (int col = 0; col < cf->ncols; col++) {
+        if (cf->cols[glyph][col] == 0) continue;
+        if (*first < 0) *first = col;
+        *last = col;
+    }
+    return *first >= 0;
+}
+
+static int is_digit_glyph(int glyph)
+{
+    int c = glyph + FONT_FIRST_CHAR;
+    return c >= '0' && c <= '9';
+}
+
+static void put_comment_char(FILE *f, int glyph)
+{
+    int c = glyph + FONT_FIRST_CHAR;
+    fprintf(f, "/* 0x%02X %c */", c, (c >= 0x21 && c < 0x7F && c != '\\') ? c : ' ');
+}
+
+/* Pre-rotated fixed 7x10 table, including the blank spacing column */
+static void write_fixed_7x10(FILE *f, const column_font_t *cf)
+{
+    fprintf(f, "/* Page-major 7x10 glyphs: FONT7X10_COLS + 1 columns of page 0 (rows 0..7)\n"
+               "   followed by the same columns of page 1 (rows 8..9 in bits 0..1). */\n");
+    fprintf(f, "const uint8_t font7x10_pages[FONT7X10_COUNT][FONT7X10_GLYPH_BYTES] = {\n");
+
+    for (int i = 0; i < ART_COUNT; i++) {
+        fprintf(f, "    ");
+        put_comment_char(f, i);
+        fprintf(f, " {");
+        for (int b = 0; b < 2 * ART_ADVANCE; b++) {
+            int page = b / ART_ADVANCE;
+            int col = b % ART_ADVANCE;
+            uint8_t v = (col < ART_COLS) ? (uint8_t)(cf->cols[i][col] >> (8 * page)) : 0x00;
+            fprintf(f, "0x%02X%s", v, (b + 1 < 2 * ART_ADVANCE) ? "," : "");
+        }
+        fprintf(f, "}%s\n", (i + 1 < ART_COUNT) ? "," : "");
+    }
+    fprintf(f, "};\n\n");
+
+    fprintf(f, "const ssd1306_font_t ssd1306_font_7x10 = {\n"
+               "    .height = FONT7X10_ROWS,\n"
+               "    .width = FONT7X10_COLS + 1,\n"
+               "    .spacing = 0,\n"
+               "    .first_char = FONT7X10_FIRST_CHAR,\n"
+               "    .count = FONT7X10_COUNT,\n"
+               "    .widths = NULL,\n"
+               "    .offsets = NULL,\n"
+               "    .bitmaps = &font7x10_pages[0][0],\n"
+               "};\n\n");
+}
+
+/* Proportional descriptor: blank columns trimmed from each glyph, digits
+   share one width so numbers do not jitter when they change */
+static void write_proportional(FILE *f, const column_font_t *cf, uint8_t space_width)
+{
+    int first[FONT_COUNT], width[FONT_COUNT];
+    int digit_first = MAX_COLS, digit_last = -1;
+
+    for (int i = 0; i < FONT_COUNT; i++) {
+        int lo, hi;
+        if (glyph_extent(cf, i, &lo, &hi)) {
+            first[i] = lo;
+            width[i] = hi - lo + 1;
+            if (is_digit_glyph(i)) {
+                if (lo < digit_first) digit_first = lo;
+                if (hi > digit_last) digit_last = hi;
+            }
+        } else {
+            first[i] = 0;
+            width[i] = space_width;
+        }
+    }
+    for (int i = 0; i < FONT_COUNT; i++) {
+        if (!is_digit_glyph(i) || digit_last < 0) continue;
+        first[i] = digit_first;
+        width[i] = digit_last - digit_first + 1;
+    }
+
+    int pages = (cf->height + 7) / 8;
+    int max_width = 0;
+    unsigned offset = 0;
+
+    fprintf(f, "static const uint8_t font%sp_bitmaps[] = {\n", cf->name);
+    for (int i = 0; i < FONT_COUNT; i++) {
+        fprintf(f, "    ");
+        put_comment_char(f, i);
+        for (int p = 0; p < pages; p++) {
+            for (int col = 0; col < width[i]; col++) {
+                int src = first[i] + col;
+                uint8_t v = (src < cf->ncols) ? (uint8_t)(cf->cols[i][src] >> (8 * p)) : 0x00;
+                fprintf(f, " 0x%02X,", v);
+            }
+        }
+        fprintf(f, "\n");
+        if (width[i] > max_width) max_width = width[i];
+    }
+    fprintf(f, "};\n\n");
+
+    fprintf(f, "static const uint8_t font%sp_widths[FONT_COUNT] = {", cf->name);
+    for (int i = 0; i < FONT_COUNT; i++) {
+        fprintf(f, "%s%d%s", (i % 16 == 0) ? "\n    " : " ", width[i], (i + 1 < FONT_COUNT) ? "," : "");
+    }
+    fprintf(f, "\n};\n\n");
+
+    fprintf(f, "static const uint16_t font%sp_offsets[FONT_COUNT] = {", cf->name);
+    for (int i = 0; i < FONT_COUNT; i++) {
+        fprintf(f, "%s%u%s", (i % 16 == 0) ? "\n    " : " ", offset, (i + 1 < FONT_COUNT) ? "," : "");
+        offset += (unsigned)(width[i] * pages);
+    }
+    fprintf(f, "\n};\n\n");
+
+    fprintf(f, "const ssd1306_font_t ssd1306_font_%sp = {\n"
+               "    .height = %d,\n"
+               "    .width = %d,\n"
+               "    .spacing = %d,\n"
+               "    .first_char = FONT_FIRST_CHAR,\n"
+               "    .count = FONT_COUNT,\n"
+               "    .widths = font%sp_widths,\n"
+               "    .offsets = font%sp_offsets,\n"
+               "    .bitmaps = font%sp_bitmaps,\n"
+               "};\n\n",
+            cf->name, cf->height, max_width, PROP_SPACING, cf->name, cf->name, cf->name);
+}
+
+static column_font_t font_7x10;
+static column_font_t font_5x8;
+
+int main(int argc, char **argv)
+{
+    if (argc != 3) {
+        fprintf(stderr, "usage: %s <font7x10.txt> <output.c>\n", argv[0]);
+        return 2;
+    }
+
+    const char *src_name = strrchr(argv[1], '/');
+    src_name = (src_name != NULL) ? src_name + 1 : argv[1];
+
+    if (parse_font(argv[1]) != 0) return 1;
+    art_to_columns(&font_7x10);
+    font5x8_to_columns(&font_5x8);
+
+    FILE *f = fopen(argv[2], "w");
+    if (f == NULL) {
+        fprintf(stderr, "fontgen: cannot create %s\n", argv[2]);
+        return 1;
+    }
+
+    fprintf(f, "/* Generated by tools/fontgen from %s and font5x8 - do not edit. */\n", src_name);
+    fprintf(f, "#include \"ssd1306_fonts.h\"\n\n");
+    write_fixed_7x10(f, &font_7x10);
+    write_proportional(f, &font_7x10, PROP_SPACE_7X10);
+    write_proportional(f, &font_5x8, PROP_SPACE_5X8);
+
+    if (fclose(f) != 0) {
+        fprintf(stderr, "fontgen: write error on %s\n", argv[2]);
+        return 1;
+    }
+    return 0;
+}
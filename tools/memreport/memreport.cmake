@@ -0,0 +1,127 @@
+# RAM / flash budget report for the firmware image.
+#
+# Reads the symbol table of the linked ELF with nm and writes a text report:
+# region totals from the linker script symbols (.data, .bss, heap and stack
+# reservations, what is left of the 20 KB RAM and 128 KB flash), then every
+# sized symbol of each region, largest first.
+#
+# Usage (see the memreport target in CMakeLists.txt):
+#   cmake -DNM=<nm> -DELF=<firmware.elf> -DOUT=<report.txt>
+#         [-DFLASH_SIZE=<bytes>] [-DTOP=<symbols per region>] -P memreport.cmake
+
+cmake_minimum_required(VERSION 3.22)
+
+foreach(var NM ELF OUT)
+    if(NOT DEFINED ${var})
+        message(FATAL_ERROR "memreport: ${var} is not set")
+    endif()
+endforeach()
+if(NOT DEFINED FLASH_SIZE)
+    set(FLASH_SIZE 131072)
+endif()
+if(NOT DEFINED TOP)
+    set(TOP 0)
+endif()
+
+set(RAM_ORIGIN 0x20000000)
+set(FLASH_ORIGIN 0x08000000)
+
+execute_process(COMMAND ${NM} ${ELF}
+    OUTPUT_VARIABLE all_syms RESULT_VARIABLE rc)
+if(NOT rc EQUAL 0)
+    message(FATAL_ERROR "memreport: ${NM} failed on ${ELF}")
+endif()
+execute_process(COMMAND ${NM} --print-size --size-sort --reverse-sort ${ELF}
+    OUTPUT_VARIABLE sized_syms RESULT_VARIABLE rc)
+if(NOT rc EQUAL 0)
+    message(FATAL_ERROR "memreport: ${NM} failed on ${ELF}")
+endif()
+
+# Linker script symbols, by name -> decimal value
+foreach(name _sdata _edata _sbss _ebss _sidata _estack _Min_Heap_Size _Min_Stack_Size)
+    if(NOT all_syms MATCHES "([0-9a-fA-F]+) [A-Za-z] ${name}\n")
+        message(FATAL_ERROR "memreport: symbol ${name} not found in ${ELF}")
+    endif()
+    math(EXPR ${name} "0x${CMAKE_MATCH_1}")
+endforeach()
+
+math(EXPR ram_size "${_estack} - ${RAM_ORIGIN}")
+math(EXPR data_size "${_edata} - ${_sdata}")
+math(EXPR bss_size "${_ebss} - ${_sbss}")
+math(EXPR ram_free "${ram_size} - ${data_size} - ${bss_size} - ${_Min_Heap_Size} - ${_Min_Stack_Size}")
+math(EXPR code_size "${_sidata} - ${FLASH_ORIGIN}")
+math(EXPR flash_used "${code_size} + ${data_size}")
+math(EXPR flash_free "${FLASH_SIZE} - ${flash_used}")
+
+# Right-align value in a field of width characters
+function(pad out width value)
+    string(LENGTH "${value}" len)
+    while(len LESS width)
+        string(PREPEND value " ")
+        math(EXPR len "${len} + 1")
+    endwhile()
+    set(${out} "${value}" PARENT_SCOPE)
+endfunction()
+
+set(report "Memory budget of ${ELF}\n\n")
+foreach(row
+        "RAM;${ram_size}"
+        "  .data;${data_size}"
+        "  .bss;${bss_size}"
+        "  heap reserve;${_Min_Heap_Size}"
+        "  stack reserve;${_Min_Stack_Size}"
+        "  free;${ram_free}"
+        "FLASH;${FLASH_SIZE}"
+        "  code + const;${code_size}"
+        "  .data init;${data_size}"
+        "  free;${flash_free}")
+    list(GET row 0 label)
+    list(GET row 1 value)
+    pad(value 7 "${value}")
+    string(APPEND report "${label}")
+    string(LENGTH "${label}" len)
+    math(EXPR fill "16 - ${len}")
+    string(REPEAT " " ${fill} spaces)
+    string(APPEND report "${spaces}${value}\n")
+endforeach()
+
+# Sized symbols split by the region of their address
+string(REPLACE "\n" ";" lines "${sized_syms}")
+set(ram_rows "")
+set(flash_rows "")
+set(ram_count 0)
+set(flash_count 0)
+foreach(line IN LISTS lines)
+    if(NOT line MATCHES "^([0-9a-fA-F]+) ([0-9a-fA-F]+) ([A-Za-z]) (.+)$")
+        continue()
+    endif()
+    set(addr ${CMAKE_MATCH_1})
+    math(EXPR size "0x${CMAKE_MATCH_2}")
+    set(type ${CMAKE_MATCH_3})
+    set(name ${CMAKE_MATCH_4})
+    math(EXPR addr_value "0x${addr}")
+    pad(size_text 7 "${size}")
+    set(row "${size_text}  ${addr}  ${type}  ${name}\n")
+    if(addr_value GREATER_EQUAL RAM_ORIGIN)
+        if(TOP EQUAL 0 OR ram_count LESS TOP)
+            string(APPEND ram_rows "${row}")
+        endif()
+        math(EXPR ram_count "${ram_count} + 1")
+    elseif(addr_value GREATER_EQUAL FLASH_ORIGIN)
+        if(TOP EQUAL 0 OR flash_count LESS TOP)
+            string(APPEND flash_rows "${row}")
+        endif()
+        math(EXPR flash_count "${flash_count} + 1")
+    endif()
+endforeach()
+
+string(APPEND report "\nRAM symbols (${ram_count}), largest first\n"
+                     "   size  address   t  symbol\n${ram_rows}")
+string(APPEND report "\nFLASH symbols (${flash_count}), largest first\n"
+                     "   size  address   t  symbol\n${flash_rows}")
+
+file(WRITE ${OUT} "${report}")
+message("RAM ${ram_size}: data ${data_size}, bss ${bss_size}, heap ${_Min_Heap_Size}, "
+        "stack ${_Min_Stack_Size}, free ${ram_free}")
+message("FLASH ${FLASH_SIZE}: used ${flash_used}, free ${flash_free}")
+message("Report written to ${OUT}")